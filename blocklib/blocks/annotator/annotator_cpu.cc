@@ -30,7 +30,8 @@ annotator_cpu::annotator_cpu(const block_args& args)
       d_when(args.when),
       d_num_inputs(args.num_inputs),
       d_num_outputs(args.num_outputs),
-      d_tpp(args.tpp)
+      d_tpp(args.tpp),
+      d_key(pmtf::pmt_string::intern("seq"))
 {
 
     set_tag_propagation_policy(args.tpp);
@@ -57,9 +58,11 @@ work_return_code_t annotator_cpu::work(std::vector<block_work_input>& work_input
             d_stored_tags.end(), tags.begin(), tags.end());
     }
 
-    // Storing the current noutput_items as the value to the "noutput_items" key
-    pmtf::pmt_sptr srcid = pmtf::pmt_string::make(alias());
-    pmtf::pmt_sptr key = pmtf::pmt_string::make("seq");
+    // The alias can change after construction, so only re-intern the srcid if it did
+    if (!d_srcid || d_srcid_alias != alias()) {
+        d_srcid_alias = alias();
+        d_srcid = pmtf::pmt_string::intern(d_srcid_alias);
+    }
 
     // Work does nothing to the data stream; just copy all inputs to outputs
     // Adds a new tag when the number of items read is a multiple of d_when
@@ -73,7 +76,7 @@ work_return_code_t annotator_cpu::work(std::vector<block_work_input>& work_input
         for (unsigned i = 0; i < d_num_outputs; i++) {
             if (abs_N % d_when == 0) {
                 auto value = pmtf::pmt_scalar<uint64_t>::make(d_tag_counter++);
-                work_output[i].buffer->add_tag(abs_N, key, value, srcid);
+                work_output[i].buffer->add_tag(abs_N, d_key, value, d_srcid);
             }
 
             // We don't really care about the data here
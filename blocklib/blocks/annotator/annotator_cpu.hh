@@ -20,6 +20,11 @@ private:
     std::vector<tag_t> d_stored_tags;
     size_t d_num_inputs, d_num_outputs;
     tag_propagation_policy_t d_tpp;
+
+    // Interned, so they are built once rather than on every work() call
+    pmtf::pmt_sptr d_key;
+    pmtf::pmt_sptr d_srcid;
+    std::string d_srcid_alias;
 };
 
 } // namespace blocks
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <gnuradio/blocks/msg_forward.hh>
+#include <atomic>
 
 namespace gr {
 namespace blocks {
@@ -12,9 +13,17 @@ public:
     virtual work_return_code_t work(std::vector<block_work_input>& work_input,
                                     std::vector<block_work_output>& work_output) override;
 
+    size_t message_count() const override { return d_msg_count; }
+
 protected:
     size_t d_itemsize;
-    void handle_msg_in(pmtf::pmt_sptr msg) { gr_log_info(_logger, "got message: "); }
+    std::atomic<size_t> d_msg_count = 0;
+    void handle_msg_in(pmtf::pmt_sptr msg)
+    {
+        gr_log_debug(_debug_logger, "got message");
+        d_msg_count++;
+        _msg_out->post(msg);
+    }
 };
 
 } // namespace blocks
@@ -47,7 +47,7 @@ file_source_cpu::file_source_cpu(const file_source::block_args& args) : file_sou
 
     std::stringstream str;
     str << name() << id();
-    _id = pmtf::pmt_string::make(str.str());
+    _id = pmtf::pmt_string::intern(str.str());
 }
 
 
@@ -229,7 +229,16 @@ void file_source_cpu::do_update()
     }
 }
 
-void file_source_cpu::set_begin_tag(pmtf::pmt_sptr val) { d_add_begin_tag = val; }
+void file_source_cpu::set_begin_tag(pmtf::pmt_sptr val)
+{
+    // Use the interned symbol for string keys so downstream blocks can match the tag
+    // key by pointer
+    if (val && val->data_type() == pmtf::Data::PmtString) {
+        val = pmtf::pmt_string::intern(
+            std::static_pointer_cast<pmtf::pmt_string>(val)->value());
+    }
+    d_add_begin_tag = val;
+}
 
 work_return_code_t file_source_cpu::work(std::vector<block_work_input>& work_input,
                                   std::vector<block_work_output>& work_output)
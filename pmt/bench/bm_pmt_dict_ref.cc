@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <string>
@@ -11,6 +12,19 @@ namespace po = boost::program_options;
 
 using namespace pmtf;
 
+pmt_map<std::string>::sptr make_dict(uint32_t items)
+{
+    std::map<std::string, pmt_sptr> starting_map;
+    for (uint32_t k = 0; k < items; k++) {
+        auto key = std::string("key" + std::to_string(k));
+        auto value = pmt_scalar<int32_t>::make(k);
+
+        starting_map[key] = value;
+    }
+
+    return pmt_map<std::string>::make(starting_map);
+}
+
 bool run_test(const int times, pmt_map<std::string>::sptr d, int32_t index)
 {
     std::stringbuf sb; // fake channel
@@ -20,7 +34,7 @@ bool run_test(const int times, pmt_map<std::string>::sptr d, int32_t index)
     bool valid = true;
     for (int i=0; i< times; i++)
     {
-        auto ref = d->ref(key);
+        auto ref = d->at(key);
 
         // if (ref == nullptr)
         //    valid = false;
@@ -33,11 +47,75 @@ bool run_test(const int times, pmt_map<std::string>::sptr d, int32_t index)
     return valid;
 }
 
+bool run_test_value(const int times, pmt_map<std::string>::sptr d, int32_t index)
+{
+    auto key = std::string("key" + std::to_string(index));
+
+    bool valid = true;
+    for (int i = 0; i < times; i++) {
+        // Copy out the whole map, then search it
+        auto ref = d->value()[key];
+        if (std::static_pointer_cast<pmt_scalar<int32_t>>(ref)->value() != index) {
+            valid = false;
+        }
+    }
+    return valid;
+}
+
+template <typename F>
+double time_per_lookup(F f, uint64_t times, bool& valid)
+{
+    auto t1 = std::chrono::steady_clock::now();
+    valid = f() && valid;
+    auto t2 = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() /
+           (double)times;
+}
+
+/**
+ * @brief Print the cost of a single lookup for dictionaries of growing size
+ *
+ */
+void run_sweep(uint64_t samples, uint32_t max_items)
+{
+    std::cout << "items,at_ns,contains_ns,value_ns" << std::endl;
+    bool valid = true;
+    for (uint32_t items = 1; items <= max_items; items *= 10) {
+        auto d = make_dict(items);
+        int32_t index = items / 2;
+        auto key = std::string("key" + std::to_string(index));
+
+        auto at_ns = time_per_lookup(
+            [&] { return run_test(samples, d, index); }, samples, valid);
+        auto contains_ns = time_per_lookup(
+            [&] {
+                bool found = true;
+                for (uint64_t i = 0; i < samples; i++) {
+                    found = d->contains(key) && found;
+                }
+                return found;
+            },
+            samples,
+            valid);
+        // Decoding the full map gets slow quickly, so do fewer of them
+        uint64_t value_samples = std::max<uint64_t>(1, samples / items);
+        auto value_ns = time_per_lookup(
+            [&] { return run_test_value(value_samples, d, index); },
+            value_samples,
+            valid);
+
+        std::cout << items << "," << at_ns << "," << contains_ns << "," << value_ns
+                  << std::endl;
+    }
+    std::cout << "[PROFILE_VALID]" << valid << "[PROFILE_VALID]" << std::endl;
+}
+
 int main(int argc, char* argv[])
 {
     uint64_t samples;
     uint32_t items;
     uint32_t index;
+    uint32_t max_items;
 
     po::options_description desc("Basic Test Flow Graph");
     desc.add_options()("help,h", "display help")(
@@ -49,7 +127,10 @@ int main(int argc, char* argv[])
         "Number of items in dict")(
         "index",
         po::value<uint32_t>(&index)->default_value(0),
-        "Index for lookup");
+        "Index for lookup")(
+        "sweep",
+        po::value<uint32_t>(&max_items)->default_value(0),
+        "Instead of a single run, time lookups for dict sizes 1, 10, ... up to this");
 
 
     po::variables_map vm;
@@ -61,18 +142,13 @@ int main(int argc, char* argv[])
         return 0;
     }
 
-    {
-        // Create the dictionary
-        std::map<std::string,pmt_sptr> starting_map;
-        for (uint32_t k = 0; k < items; k++)
-        {
-            auto key = std::string("key" + std::to_string(k));
-            auto value = pmt_scalar<int32_t>::make(k);
-
-            starting_map[key] = value;
-        }
+    if (max_items > 0) {
+        run_sweep(samples, max_items);
+        return 0;
+    }
 
-        auto d = pmt_map<std::string>::make(starting_map);
+    {
+        auto d = make_dict(items);
 
         auto t1 = std::chrono::steady_clock::now();
 
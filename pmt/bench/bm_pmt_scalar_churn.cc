@@ -0,0 +1,102 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+#include <pmt/pmtf_scalar.hh>
+
+using namespace pmtf;
+
+/**
+ * @brief Create and destroy scalars the way tag-heavy blocks do
+ *
+ * Keeps up to `live` scalars alive at a time, so the allocator sees the same
+ * create/release churn as a block emitting tags that are pruned shortly after
+ *
+ */
+bool run_test(const uint64_t times, const size_t live, const bool serialize)
+{
+    std::vector<pmt_scalar<uint64_t>::sptr> held;
+    held.reserve(live);
+    std::stringbuf sb; // fake channel
+
+    bool valid = true;
+    for (uint64_t i = 0; i < times; i++) {
+        if (held.size() == live) {
+            held.clear();
+        }
+        auto p = pmt_scalar<uint64_t>::make(i);
+        if (serialize) {
+            sb.str("");
+            p->serialize(sb);
+        }
+        if (p->value() != i) {
+            valid = false;
+        }
+        held.push_back(p);
+    }
+    return valid;
+}
+
+int main(int argc, char* argv[])
+{
+    uint64_t samples;
+    size_t live;
+    int nthreads;
+
+    po::options_description desc("PMT Scalar Create/Destroy Benchmark");
+    desc.add_options()("help,h", "display help")(
+        "samples",
+        po::value<uint64_t>(&samples)->default_value(10000000),
+        "Number of scalars created per thread")(
+        "live",
+        po::value<size_t>(&live)->default_value(64),
+        "Number of scalars kept alive at a time")(
+        "nthreads", po::value<int>(&nthreads)->default_value(1), "Number of threads")(
+        "serialize", "Serialize every scalar as well");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    bool serialize = vm.count("serialize") > 0;
+    if (live == 0) {
+        live = 1;
+    }
+
+    {
+        std::vector<std::thread> threads;
+        std::vector<char> valid(nthreads, 0);
+
+        auto t1 = std::chrono::steady_clock::now();
+
+        for (int t = 0; t < nthreads; t++) {
+            threads.emplace_back(
+                [&, t] { valid[t] = run_test(samples, live, serialize); });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        auto t2 = std::chrono::steady_clock::now();
+        auto time =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / 1e9;
+
+        bool all_valid = true;
+        for (auto v : valid) {
+            all_valid = all_valid && v;
+        }
+
+        std::cout << "[PROFILE_TIME]" << time << "[PROFILE_TIME]" << std::endl;
+        std::cout << "[PROFILE_VALID]" << all_valid << "[PROFILE_VALID]" << std::endl;
+    }
+}
@@ -0,0 +1,127 @@
+#include <chrono>
+#include <iostream>
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+#include <pmt/pmtf_batch.hh>
+#include <pmt/pmtf_scalar.hh>
+#include <pmt/pmtf_vector.hh>
+
+using namespace pmtf;
+
+std::vector<pmt_sptr> make_pmts(size_t num, size_t veclen)
+{
+    std::vector<pmt_sptr> pmts;
+    for (size_t i = 0; i < num; i++) {
+        if (veclen) {
+            pmts.push_back(pmt_vector<int32_t>::make(std::vector<int32_t>(veclen, i)));
+        } else {
+            pmts.push_back(pmt_scalar<uint64_t>::make(i));
+        }
+    }
+    return pmts;
+}
+
+/**
+ * @brief One serialize/deserialize per pmt, as pmt_base provides
+ *
+ */
+bool run_test_single(const uint64_t times, const std::vector<pmt_sptr>& pmts)
+{
+    bool valid = true;
+    std::stringbuf sb; // fake channel
+    for (uint64_t i = 0; i < times; i += pmts.size()) {
+        sb.str("");
+        for (auto& p : pmts) {
+            p->serialize(sb);
+        }
+        for (auto& p : pmts) {
+            auto q = pmt_base::deserialize(sb);
+            if (q->data_type() != p->data_type()) {
+                valid = false;
+            }
+        }
+    }
+    return valid;
+}
+
+/**
+ * @brief The same pmts, packed into one frame per batch and read back as views
+ *
+ */
+bool run_test_batch(const uint64_t times, const std::vector<pmt_sptr>& pmts)
+{
+    bool valid = true;
+    std::stringbuf sb; // fake channel
+    pmt_batch_writer writer;
+    pmt_batch_reader reader;
+    for (uint64_t i = 0; i < times; i += pmts.size()) {
+        sb.str("");
+        for (auto& p : pmts) {
+            writer.add(p);
+        }
+        writer.write(sb);
+
+        if (!reader.read(sb) || reader.size() != pmts.size()) {
+            valid = false;
+            continue;
+        }
+        size_t k = 0;
+        for (auto v : reader) {
+            if (v.data_type() != pmts[k++]->data_type()) {
+                valid = false;
+            }
+        }
+    }
+    return valid;
+}
+
+int main(int argc, char* argv[])
+{
+    uint64_t samples;
+    size_t batch;
+    size_t veclen;
+
+    po::options_description desc("PMT Batch Serialization Benchmark");
+    desc.add_options()("help,h", "display help")(
+        "samples",
+        po::value<uint64_t>(&samples)->default_value(1000000),
+        "Number of pmts to serialize and deserialize")(
+        "batch",
+        po::value<size_t>(&batch)->default_value(256),
+        "Number of pmts per frame")(
+        "veclen",
+        po::value<size_t>(&veclen)->default_value(0),
+        "Length of int32 vector pmts (0: uint64 scalars)")(
+        "single", "Serialize one pmt at a time instead of in frames");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    if (batch == 0) {
+        batch = 1;
+    }
+
+    {
+        auto pmts = make_pmts(batch, veclen);
+
+        auto t1 = std::chrono::steady_clock::now();
+
+        auto valid = vm.count("single") ? run_test_single(samples, pmts)
+                                        : run_test_batch(samples, pmts);
+
+        auto t2 = std::chrono::steady_clock::now();
+        auto time =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / 1e9;
+
+        std::cout << "[PROFILE_TIME]" << time << "[PROFILE_TIME]" << std::endl;
+        std::cout << "[PROFILE_VALID]" << valid << "[PROFILE_VALID]" << std::endl;
+    }
+}
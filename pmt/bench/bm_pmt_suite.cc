@@ -0,0 +1,374 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+#include <pmt/pmtf_map.hh>
+#include <pmt/pmtf_scalar.hh>
+#include <pmt/pmtf_string.hh>
+#include <pmt/pmtf_vector.hh>
+#include <pmt/pmtf_view.hh>
+
+using namespace pmtf;
+
+/**
+ * Micro-benchmarks for every pmt type, reported as JSON
+ *
+ * Each case times one operation on one type and size:
+ *
+ *     create            make() from a native value
+ *     copy              make() from the value of an existing pmt
+ *     serialize         serialize() of an existing pmt, i.e. re-posting it
+ *     create_serialize  make() and serialize() of a new pmt
+ *     view              verify an encoding and wrap it in a pmt_view
+ *     deserialize       pmt_view of an encoding, copied into a new pmt
+ *     ref               read one element or map entry (cycling through all of them)
+ *     view_ref          the same, through a pmt_view of the encoding
+ *     assign            set_value() of a vector with a value of the same length
+ *     scan              read every element of a vector through elements()
+ *
+ * Cases run until --min-time has passed, so ns_per_op is an average over many calls.
+ * VectorBool and VectorComplex128 are in the schema but have no pmt class yet.
+ */
+
+struct result {
+    std::string name;
+    std::string operation;
+    Data type;
+    size_t size;
+    size_t bytes; // size of the encoding
+    uint64_t iterations;
+    double ns_per_op;
+};
+
+struct config {
+    double min_time;
+    std::string filter;
+};
+
+config g_config;
+std::vector<result> g_results;
+volatile size_t g_sink; // keeps the timed work from being optimized out
+
+/**
+ * @brief A streambuf that keeps its memory between writes, so serialize is not timed
+ * against std::stringbuf growing
+ *
+ */
+class buffer_sink : public std::streambuf
+{
+public:
+    void clear() { _buf.clear(); }
+    const std::vector<uint8_t>& data() const { return _buf; }
+
+protected:
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        _buf.insert(_buf.end(), s, s + n);
+        return n;
+    }
+
+private:
+    std::vector<uint8_t> _buf;
+};
+
+std::vector<uint8_t> encoding(pmt_sptr p)
+{
+    buffer_sink sb;
+    p->serialize(sb);
+    return sb.data();
+}
+
+template <class F>
+void measure(const std::string& operation, Data type, size_t size, size_t bytes, F op)
+{
+    auto name = operation + "/" + EnumNameData(type) + "/" + std::to_string(size);
+    if (!g_config.filter.empty() && name.find(g_config.filter) == std::string::npos) {
+        return;
+    }
+
+    op(); // warm up caches and the pmt pool
+
+    // Double the batch each round so the clock is read rarely for fast operations
+    uint64_t iterations = 0;
+    uint64_t batch = 1;
+    double elapsed = 0;
+    while (elapsed < g_config.min_time) {
+        auto t1 = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < batch; i++) {
+            op();
+        }
+        auto t2 = std::chrono::steady_clock::now();
+        elapsed += std::chrono::duration<double>(t2 - t1).count();
+        iterations += batch;
+        batch *= 2;
+    }
+
+    g_results.push_back(
+        { name, operation, type, size, bytes, iterations, elapsed * 1e9 / iterations });
+}
+
+/**
+ * @brief The cases every type has
+ *
+ * @param make returns a new pmt
+ * @param copy returns a new pmt with the value of its argument
+ */
+template <class Make, class Copy>
+void run_common(Data type, size_t size, Make make, Copy copy)
+{
+    auto p = make();
+    auto enc = encoding(p);
+    buffer_sink sb;
+
+    measure("create", type, size, enc.size(), [&] {
+        g_sink = g_sink + (size_t)make()->data_type();
+    });
+    measure("copy", type, size, enc.size(), [&] {
+        g_sink = g_sink + (size_t)copy(p)->data_type();
+    });
+    measure("serialize", type, size, enc.size(), [&] {
+        sb.clear();
+        p->serialize(sb);
+        g_sink = g_sink + sb.data().size();
+    });
+    measure("create_serialize", type, size, enc.size(), [&] {
+        sb.clear();
+        make()->serialize(sb);
+        g_sink = g_sink + sb.data().size();
+    });
+    measure("view", type, size, enc.size(), [&] {
+        auto v = pmt_view::size_prefixed(enc.data(), enc.size());
+        g_sink = g_sink + (size_t)v.data_type();
+    });
+    measure("deserialize", type, size, enc.size(), [&] {
+        auto q = pmt_view::size_prefixed(enc.data(), enc.size()).to_pmt();
+        g_sink = g_sink + (size_t)q->data_type();
+    });
+}
+
+template <class T>
+void run_scalar(Data type)
+{
+    run_common(
+        type,
+        1,
+        [] { return pmt_scalar<T>::make(T(1)); },
+        [](const typename pmt_scalar<T>::sptr& p) {
+            return pmt_scalar<T>::make(p->value());
+        });
+}
+
+template <class T>
+void run_vector(Data type, const std::vector<size_t>& sizes)
+{
+    for (auto n : sizes) {
+        std::vector<T> val(n, T(1));
+        run_common(
+            type,
+            n,
+            [&] { return pmt_vector<T>::make(val); },
+            [](const typename pmt_vector<T>::sptr& p) {
+                return pmt_vector<T>::make(p->data(), p->size());
+            });
+
+        auto p = pmt_vector<T>::make(val);
+        auto enc = encoding(p);
+        auto v = pmt_view::size_prefixed(enc.data(), enc.size());
+        size_t k = 0;
+        measure("ref", type, n, enc.size(), [&] {
+            g_sink = g_sink + (p->ref(k) == T() ? 0 : 1);
+            k = (k + 1) % n;
+        });
+        measure("view_ref", type, n, enc.size(), [&] {
+            g_sink = g_sink + (v.template vector<T>().ref(k) == T() ? 0 : 1);
+            k = (k + 1) % n;
+        });
+        measure("assign", type, n, enc.size(), [&] {
+            p->set_value(val);
+            g_sink = g_sink + (size_t)p->data_type();
+        });
+        measure("scan", type, n, enc.size(), [&] {
+            auto data = p->elements();
+            T acc = T();
+            for (size_t i = 0; i < n; i++) {
+                acc += data[i];
+            }
+            g_sink = g_sink + (acc == T() ? 0 : 1);
+        });
+    }
+}
+
+void run_string(const std::vector<size_t>& sizes)
+{
+    for (auto n : sizes) {
+        std::string val(n, 'x');
+        run_common(
+            Data::PmtString,
+            n,
+            [&] { return pmt_string::make(val); },
+            [](const pmt_string::sptr& p) { return pmt_string::make(p->value()); });
+    }
+}
+
+void run_map(const std::vector<size_t>& sizes)
+{
+    for (auto n : sizes) {
+        std::map<std::string, pmt_sptr> val;
+        std::vector<std::string> keys;
+        for (size_t i = 0; i < n; i++) {
+            keys.push_back("key" + std::to_string(i));
+            val[keys.back()] = pmt_scalar<int32_t>::make(i);
+        }
+        run_common(
+            Data::MapString,
+            n,
+            [&] { return pmt_map<std::string>::make(val); },
+            [](const pmt_map<std::string>::sptr& p) {
+                return pmt_map<std::string>::make(p->value());
+            });
+
+        auto p = pmt_map<std::string>::make(val);
+        auto enc = encoding(p);
+        auto v = pmt_view::size_prefixed(enc.data(), enc.size());
+        size_t k = 0;
+        measure("ref", Data::MapString, n, enc.size(), [&] {
+            g_sink = g_sink + (size_t)p->at(keys[k])->data_type();
+            k = (k + 1) % n;
+        });
+        measure("view_ref", Data::MapString, n, enc.size(), [&] {
+            g_sink = g_sink + (size_t)v.ref(keys[k]).data_type();
+            k = (k + 1) % n;
+        });
+    }
+}
+
+void run_list(const std::vector<size_t>& sizes)
+{
+    for (auto n : sizes) {
+        std::vector<pmt_sptr> val;
+        for (size_t i = 0; i < n; i++) {
+            val.push_back(pmt_scalar<int32_t>::make(i));
+        }
+        run_common(
+            Data::VectorPmt,
+            n,
+            [&] { return pmt_list::make(val); },
+            [](const pmt_list::sptr& p) { return pmt_list::make(p->value()); });
+
+        auto p = pmt_list::make(val);
+        auto enc = encoding(p);
+        auto v = pmt_view::size_prefixed(enc.data(), enc.size());
+        size_t k = 0;
+        measure("ref", Data::VectorPmt, n, enc.size(), [&] {
+            g_sink = g_sink + (size_t)p->ref(k)->data_type();
+            k = (k + 1) % n;
+        });
+        measure("view_ref", Data::VectorPmt, n, enc.size(), [&] {
+            g_sink = g_sink + (size_t)v.list_ref(k).data_type();
+            k = (k + 1) % n;
+        });
+    }
+}
+
+void write_json(std::ostream& os, const std::vector<size_t>& sizes)
+{
+    os << "{\n  \"context\": {\n    \"min_time\": " << g_config.min_time
+       << ",\n    \"sizes\": [";
+    for (size_t i = 0; i < sizes.size(); i++) {
+        os << (i ? ", " : "") << sizes[i];
+    }
+    os << "]\n  },\n  \"benchmarks\": [";
+    for (size_t i = 0; i < g_results.size(); i++) {
+        auto& r = g_results[i];
+        os << (i ? "," : "") << "\n    {\"name\": \"" << r.name << "\", \"operation\": \""
+           << r.operation << "\", \"type\": \"" << EnumNameData(r.type)
+           << "\", \"size\": " << r.size << ", \"bytes\": " << r.bytes
+           << ", \"iterations\": " << r.iterations << ", \"ns_per_op\": " << r.ns_per_op
+           << "}";
+    }
+    os << "\n  ]\n}" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<size_t> sizes;
+    std::string output;
+
+    po::options_description desc("PMT Micro-Benchmark Suite");
+    desc.add_options()("help,h", "display help")(
+        "min-time",
+        po::value<double>(&g_config.min_time)->default_value(0.1),
+        "Seconds to run each case for")(
+        "sizes",
+        po::value<std::vector<size_t>>(&sizes)
+            ->multitoken()
+            ->default_value(std::vector<size_t>{ 1, 64, 4096 }, "1 64 4096"),
+        "Element counts for vectors, lists and maps, and lengths for strings")(
+        "filter",
+        po::value<std::string>(&g_config.filter)->default_value(""),
+        "Only run cases whose name (operation/type/size) contains this")(
+        "output",
+        po::value<std::string>(&output)->default_value(""),
+        "File to write the JSON report to (default: stdout)");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    for (auto& n : sizes) {
+        n = n ? n : 1; // the ref cases cycle through the elements
+    }
+
+    run_scalar<int8_t>(Data::ScalarInt8);
+    run_scalar<uint8_t>(Data::ScalarUInt8);
+    run_scalar<int16_t>(Data::ScalarInt16);
+    run_scalar<uint16_t>(Data::ScalarUInt16);
+    run_scalar<int32_t>(Data::ScalarInt32);
+    run_scalar<uint32_t>(Data::ScalarUInt32);
+    run_scalar<int64_t>(Data::ScalarInt64);
+    run_scalar<uint64_t>(Data::ScalarUInt64);
+    run_scalar<bool>(Data::ScalarBool);
+    run_scalar<float>(Data::ScalarFloat32);
+    run_scalar<double>(Data::ScalarFloat64);
+    run_scalar<std::complex<float>>(Data::ScalarComplex64);
+    run_scalar<std::complex<double>>(Data::ScalarComplex128);
+
+    run_vector<int8_t>(Data::VectorInt8, sizes);
+    run_vector<uint8_t>(Data::VectorUInt8, sizes);
+    run_vector<int16_t>(Data::VectorInt16, sizes);
+    run_vector<uint16_t>(Data::VectorUInt16, sizes);
+    run_vector<int32_t>(Data::VectorInt32, sizes);
+    run_vector<uint32_t>(Data::VectorUInt32, sizes);
+    run_vector<int64_t>(Data::VectorInt64, sizes);
+    run_vector<uint64_t>(Data::VectorUInt64, sizes);
+    run_vector<float>(Data::VectorFloat32, sizes);
+    run_vector<double>(Data::VectorFloat64, sizes);
+    run_vector<std::complex<float>>(Data::VectorComplex64, sizes);
+
+    run_string(sizes);
+    run_list(sizes);
+    run_map(sizes);
+
+    if (output.empty()) {
+        write_json(std::cout, sizes);
+    } else {
+        std::ofstream ofs(output);
+        if (!ofs) {
+            std::cerr << "Could not open " << output << std::endl;
+            return 1;
+        }
+        write_json(ofs, sizes);
+    }
+
+    return 0;
+}
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <pmt/pmt_generated.h>
+#include <atomic>
 #include <complex>
+#include <cstring>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -23,35 +25,45 @@ public:
 
     bool serialize(std::streambuf& sb)
     {
-        uint8_t* buf = _fbb.GetBufferPointer();
-        int size = _fbb.GetSize();
+        encode();
+        uint8_t* buf = _fbb->GetBufferPointer();
+        int size = _fbb->GetSize();
         return sb.sputn((const char*)buf, size) != std::streambuf::traits_type::eof();
     }
 
     static sptr from_buffer(const uint8_t* buf, size_t size);
     static sptr from_pmt(const pmtf::Pmt *fb_pmt);
-    static sptr deserialize(std::streambuf& sb)
-    {
-        char buf[4];
-        sb.sgetn(buf, 4);
-        // assuming little endian for now
-        uint32_t size = *((uint32_t*)&buf[0]);
-        uint8_t tmp_buf[size];
-        sb.sgetn((char*)tmp_buf, size);
-
-        return from_buffer(tmp_buf, size);
-    }
+    /**
+     * @brief Like from_pmt, for a flatbuffer kept alive by owner
+     *
+     * Maps keep reading their entries from the flatbuffer until they are first modified,
+     * instead of decoding every entry up front
+     */
+    static sptr from_pmt(const pmtf::Pmt* fb_pmt, std::shared_ptr<const void> owner);
+    /**
+     * @brief Read one pmt written by serialize() from a stream
+     *
+     * The payload goes to the heap and is verified before use; streams that end early,
+     * carry a size above max_size or do not hold a valid pmt cause an exception.  Use
+     * pmt_view::deserialize to read values without copying them into a new pmt.
+     *
+     * @param sb
+     * @return sptr
+     */
+    static sptr deserialize(std::streambuf& sb);
+    static sptr deserialize(std::streambuf& sb, size_t max_size);
 
     void build()
     {
         // std::cout << "fb size: " << _fbb.GetSize() << std::endl;
-        PmtBuilder pb(_fbb);
+        PmtBuilder pb(builder());
         pb.add_data_type(_data_type);
         pb.add_data(_data);
         _blob = pb.Finish();
-        _fbb.FinishSizePrefixed(_blob);
-        _buf = _fbb.GetBufferPointer();
+        _fbb->FinishSizePrefixed(_blob);
+        _buf = _fbb->GetBufferPointer();
         _pmt_fb = GetSizePrefixedPmt(_buf);
+        _encode_state.store(ENCODED, std::memory_order_release);
         // std::cout << "fb size: " << _fbb.GetSize() << std::endl;
     }
 
@@ -64,44 +76,194 @@ public:
         return pb.Finish();
     }
 
-    size_t size() const { return _fbb.GetSize(); }
+    /**
+     * @brief Add this pmt to another builder, reusing the existing encoding if any
+     *
+     * An encoded pmt is copied into fbb byte for byte instead of being built again, so
+     * containers of vectors and other already serialized pmts cost a memcpy per child.
+     * Pmts without a current encoding are built into fbb directly.
+     *
+     * @param fbb
+     * @return flatbuffers::Offset<Pmt>
+     */
+    flatbuffers::Offset<Pmt> splice(flatbuffers::FlatBufferBuilder& fbb);
+
+    size_t size() const
+    {
+        encode();
+        return _fbb->GetSize();
+    }
     uint8_t* buffer_pointer() const
     {
-        if (_vec_buf.size() > 0) {
-            return (uint8_t *)&_vec_buf[0];
-        } else {
-            return _fbb.GetBufferPointer();
-        }
+        encode();
+        return _fbb->GetBufferPointer();
     }
 
-    void set_buffer(const uint8_t *data, size_t len)
+    /**
+     * @brief Content hash, computed on first use and cached until the pmt changes
+     *
+     * Stable across processes and runs, and consistent with operator==
+     *
+     * @return size_t
+     */
+    size_t hash() const
     {
-        _vec_buf.resize(len);
-        memcpy(&_vec_buf[0], data, len);
+        auto h = _hash.load(std::memory_order_relaxed);
+        if (h == 0) {
+            h = compute_hash();
+            // 0 marks the cache as empty
+            h = h ? h : 1;
+            _hash.store(h, std::memory_order_relaxed);
+        }
+        return h;
     }
 
-    bool operator==(const pmt_base& other)
+    /**
+     * @brief Compare contents, checking type, then cached hashes, before any data
+     *
+     */
+    bool operator==(const pmt_base& other) const
     {
-        auto eq_types = (data_type() == other.data_type());
-        auto eq_size = (size() == other.size());
-        auto eq_data = !memcmp(buffer_pointer(), other.buffer_pointer(), size());
-        return (eq_types && eq_size && eq_data);
+        if (this == &other) {
+            return true;
+        }
+        if (data_type() != other.data_type()) {
+            return false;
+        }
+        // Only use hashes that are already there - computing one reads all the data
+        auto h1 = _hash.load(std::memory_order_relaxed);
+        auto h2 = other._hash.load(std::memory_order_relaxed);
+        if (h1 && h2 && h1 != h2) {
+            return false;
+        }
+        return equal_value(other);
     }
+    bool operator!=(const pmt_base& other) const { return !(*this == other); }
 
 protected:
     pmt_base(Data data_type) : _data_type(data_type){};
+
+    /**
+     * @brief Drop the cached encoding after the native value has changed
+     *
+     * Types that keep their value outside of the flatbuffer call this from every
+     * mutator, and the encoding is only rebuilt (from rebuild_data) the next time it is
+     * needed - so a run of updates costs one encoding instead of one per update
+     */
+    void invalidate()
+    {
+        _encode_state.store(STALE, std::memory_order_release);
+        invalidate_hash();
+    }
+
+    /**
+     * @brief Drop the cached hash - for types that change their encoding in place
+     *
+     */
+    void invalidate_hash() { _hash.store(0, std::memory_order_relaxed); }
+
+    /**
+     * @brief Compare with a pmt of the same data type
+     *
+     * The default compares encodings; types with a native value override it to avoid
+     * encoding
+     */
+    virtual bool equal_value(const pmt_base& other) const
+    {
+        return size() == other.size() &&
+               !memcmp(buffer_pointer(), other.buffer_pointer(), size());
+    }
+
+    /**
+     * @brief Hash of the value - must agree with equal_value
+     *
+     * The default hashes the encoding
+     */
+    virtual size_t compute_hash() const
+    {
+        return hash_bytes(buffer_pointer(), size(), (size_t)data_type());
+    }
+
+    /**
+     * @brief 64 bit FNV-1a, used so hashes do not depend on the standard library
+     *
+     */
+    static size_t hash_bytes(const void* data, size_t len, size_t seed)
+    {
+        uint64_t h = 14695981039346656037ull ^ seed;
+        auto p = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < len; i++) {
+            h = (h ^ p[i]) * 1099511628211ull;
+        }
+        return h;
+    }
+
+    /**
+     * @brief Bring _fbb up to date with the native value if it was invalidated
+     *
+     * Safe to call concurrently from readers of the same pmt; mutating a pmt while
+     * another thread reads it is not
+     */
+    void encode() const;
+
+    /**
+     * @brief The builder holding the encoding, created the first time it is needed
+     *
+     * Scalars and other small pmts that are never serialized never pay for one
+     *
+     */
+    flatbuffers::FlatBufferBuilder& builder()
+    {
+        if (!_fbb) {
+            _fbb = std::make_unique<flatbuffers::FlatBufferBuilder>();
+        }
+        return *_fbb;
+    }
+
+    /**
+     * @brief Whether _fbb matches the native value
+     *
+     * ENCODING is held by the one reader that is rebuilding the encoding, so readers of
+     * different pmts never wait on each other
+     */
+    enum encode_state : uint8_t { STALE, ENCODING, ENCODED };
+    mutable std::atomic<uint8_t> _encode_state = STALE;
+    mutable std::atomic<size_t> _hash = 0;
     Data _data_type;
-    flatbuffers::FlatBufferBuilder _fbb;
+    std::unique_ptr<flatbuffers::FlatBufferBuilder> _fbb;
     flatbuffers::Offset<void> _data;
     flatbuffers::Offset<Pmt> _blob;
     const pmtf::Pmt* _pmt_fb = nullptr;
     const uint8_t* _buf = nullptr;
-    std::vector<uint8_t> _vec_buf; // if the buffer came from serialized data, just store that here
 
     // PmtBuilder _builder;
 };
 
 typedef pmt_base::sptr pmt_sptr;
 
+/**
+ * @brief Hash and equality on the contents of pmt_sptrs, for unordered containers
+ *
+ * std::hash<pmt_sptr> hashes the pointer, which is what interned symbols want; use
+ * these to key on the value instead, e.g.
+ * std::unordered_map<pmt_sptr, handler, pmt_hash, pmt_equal>
+ */
+struct pmt_hash {
+    size_t operator()(const pmt_sptr& p) const { return p ? p->hash() : 0; }
+};
+
+struct pmt_equal {
+    bool operator()(const pmt_sptr& a, const pmt_sptr& b) const
+    {
+        return a == b || (a && b && *a == *b);
+    }
+};
 
 } // namespace pmtf
+
+namespace std {
+template <>
+struct hash<pmtf::pmt_base> {
+    size_t operator()(const pmtf::pmt_base& p) const { return p.hash(); }
+};
+} // namespace std
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <pmt/pmtf.hh>
+#include <pmt/pmtf_view.hh>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace pmtf {
+
+/**
+ * @brief Packs many pmts into one frame with an index of offsets
+ *
+ * Frame layout (all fields little endian uint32):
+ *
+ *     frame_size   bytes in the frame after this field
+ *     count        number of pmts
+ *     index        count (offset, size) pairs, offsets relative to the payload
+ *     payload      the size prefixed pmts, each starting on an 8 byte boundary
+ *
+ * The writer keeps its buffers between frames, so once it has grown to the frame size
+ * adding a pmt is a copy of its encoding and nothing else.
+ */
+class pmt_batch_writer
+{
+public:
+    static constexpr size_t alignment = 8;
+
+    pmt_batch_writer() { clear(); }
+
+    /**
+     * @brief Append the encoding of a pmt to the frame
+     *
+     * @param p
+     */
+    void add(const pmt_base& p);
+    void add(const pmt_sptr& p) { add(*p); }
+
+    /**
+     * @brief Number of pmts in the frame
+     *
+     */
+    size_t size() const { return _count; }
+    bool empty() const { return _count == 0; }
+
+    /**
+     * @brief Number of bytes write() will produce
+     *
+     */
+    size_t frame_size() const { return _header.size() + _payload.size(); }
+
+    /**
+     * @brief Write the frame and start a new one
+     *
+     * @param sb
+     * @return true if all bytes were written
+     */
+    bool write(std::streambuf& sb);
+
+    /**
+     * @brief Drop all pmts added since the last write, keeping the allocated memory
+     *
+     */
+    void clear();
+
+private:
+    size_t _count;
+    std::vector<uint8_t> _header; // frame_size, count and the index
+    std::vector<uint8_t> _payload;
+};
+
+/**
+ * @brief Reads frames produced by pmt_batch_writer
+ *
+ * Gives out pmt_views into the frame, so iterating over a frame neither copies nor
+ * allocates per pmt.  Each pmt is verified when it is accessed.
+ */
+class pmt_batch_reader
+{
+public:
+    /**
+     * @brief Largest frame read() accepts unless told otherwise
+     *
+     */
+    static constexpr size_t default_max_frame_size = 64 * 1024 * 1024;
+
+    pmt_batch_reader() = default;
+
+    /**
+     * @brief Read a frame in place
+     *
+     * @param frame start of the frame_size field
+     * @param size number of valid bytes at frame
+     * @param owner optional reference to whatever keeps frame alive
+     */
+    pmt_batch_reader(const uint8_t* frame,
+                     size_t size,
+                     std::shared_ptr<const void> owner = nullptr);
+
+    /**
+     * @brief Read the next frame from a stream
+     *
+     * The frame buffer is reused from the previous frame unless views into it are still
+     * held.  Throws if the stream ends in the middle of a frame, or the frame is larger
+     * than max_size or malformed.
+     *
+     * @param sb
+     * @param max_size
+     * @return false if the stream was at its end
+     */
+    bool read(std::streambuf& sb, size_t max_size = default_max_frame_size);
+
+    size_t size() const { return _count; }
+    bool empty() const { return _count == 0; }
+
+    /**
+     * @brief View of the k-th pmt in the frame
+     *
+     */
+    pmt_view view(size_t k) const;
+
+    /**
+     * @brief Copy of the k-th pmt in the frame
+     *
+     */
+    pmt_sptr get(size_t k) const { return view(k).to_pmt(); }
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = pmt_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const pmt_view*;
+        using reference = pmt_view;
+
+        const_iterator(const pmt_batch_reader* reader, size_t idx)
+            : _reader(reader), _idx(idx)
+        {
+        }
+        pmt_view operator*() const { return _reader->view(_idx); }
+        const_iterator& operator++()
+        {
+            ++_idx;
+            return *this;
+        }
+        bool operator==(const const_iterator& rhs) const { return _idx == rhs._idx; }
+        bool operator!=(const const_iterator& rhs) const { return _idx != rhs._idx; }
+
+    private:
+        const pmt_batch_reader* _reader;
+        size_t _idx;
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, _count); }
+
+private:
+    void parse(const uint8_t* frame, size_t size);
+
+    const uint8_t* _index = nullptr;
+    const uint8_t* _payload = nullptr;
+    size_t _payload_size = 0;
+    size_t _count = 0;
+    std::shared_ptr<const void> _owner;
+    std::shared_ptr<std::vector<uint8_t>> _frame; // used by read()
+};
+
+} // namespace pmtf
@@ -5,11 +5,14 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <typeindex>
 #include <typeinfo>
 #include <vector>
 
 #include <pmt/pmtf.hh>
+#include <pmt/pmtf_pool.hh>
 
 namespace pmtf {
 
@@ -21,15 +24,19 @@ public:
     typedef std::shared_ptr<pmt_map> sptr;
     static sptr make(const std::map<T, pmt_sptr>& val)
     {
-        return std::make_shared<pmt_map<T>>(val);
+        return make_pooled<pmt_map<T>>(val);
     }
     static sptr from_buffer(const uint8_t* buf, size_t size)
     {
-        return std::make_shared<pmt_map<T>>(buf, size);
+        return make_pooled<pmt_map<T>>(buf, size);
     }
     static sptr from_pmt(const pmtf::Pmt* fb_pmt)
     {
-        return std::make_shared<pmt_map<T>>(fb_pmt);
+        return make_pooled<pmt_map<T>>(fb_pmt);
+    }
+    static sptr from_pmt(const pmtf::Pmt* fb_pmt, std::shared_ptr<const void> owner)
+    {
+        return make_pooled<pmt_map<T>>(fb_pmt, owner);
     }
 
     /**
@@ -41,27 +48,60 @@ public:
     /**
      * @brief Construct a new pmt map object from a serialized flatbuffer
      *
+     * The buffer is copied, and entries are read from the copy until the map is first
+     * modified
+     *
      * @param buf
      */
     pmt_map(const uint8_t* buf, size_t size);
     /**
      * @brief Construct a new pmt map object from a flatbuffers interpreted Pmt object
      *
+     * Nothing keeps the flatbuffer alive, so every entry is decoded here
+     *
      * @param fb_pmt
      */
     pmt_map(const pmtf::Pmt* fb_pmt);
+    /**
+     * @brief Construct a map that reads its entries from a flatbuffer kept alive by
+     * owner, until it is first modified
+     *
+     * @param fb_pmt
+     * @param owner
+     */
+    pmt_map(const pmtf::Pmt* fb_pmt, std::shared_ptr<const void> owner);
 
-    void set_value(const std::map<T, pmt_sptr>& val);
+    void set_value(const std::map<T, pmt_sptr>& val)
+    {
+        _map = val;
+        release_buffer();
+        invalidate();
+    }
 
 
     /**
-     * @brief return a copy of the data stored in the flatbuffer
+     * @brief return a copy of the entries of the map
      *
      * @return const std::map<T, pmt_sptr>
      */
-    std::map<T, pmt_sptr> value() const;
+    std::map<T, pmt_sptr> value() const { return entries(); }
     const pmt_sptr data();
-    size_t size();
+
+    /**
+     * @brief Number of entries in the map
+     *
+     */
+    size_t size() const { return _fb_map ? fb_size() : _map.size(); }
+
+    typedef typename std::map<T, pmt_sptr>::const_iterator const_iterator;
+
+    /**
+     * @brief Iterate over the entries in key order
+     *
+     * A map read from a flatbuffer decodes all of its entries the first time
+     */
+    const_iterator begin() const { return entries().begin(); }
+    const_iterator end() const { return entries().end(); }
 
     void operator=(const std::map<T, pmt_sptr>& other) // copy assignment
     {
@@ -70,8 +110,114 @@ public:
 
     flatbuffers::Offset<void> rebuild_data(flatbuffers::FlatBufferBuilder& fbb);
 
-    pmt_sptr ref(const T& key);
-    void set(const T& key, pmt_sptr value);
+    /**
+     * @brief Look up a key, returning the stored value without copying it
+     *
+     * A map read from a flatbuffer finds the key with a binary search of the encoded
+     * entries and decodes only that value, each time it is looked up.  Throws if the key
+     * is not in the map
+     *
+     * @param key
+     * @return pmt_sptr
+     */
+    pmt_sptr at(const T& key) const
+    {
+        if (_fb_map) {
+            return pmt_base::from_pmt(fb_lookup(key), _owner);
+        }
+        auto it = _map.find(key);
+        if (it == _map.end()) {
+            throw std::runtime_error("Map key not found");
+        }
+        return it->second;
+    }
+    bool contains(const T& key) const
+    {
+        return _fb_map ? fb_contains(key) : _map.find(key) != _map.end();
+    }
+
+    /**
+     * @brief Look up the stored value, to change it in place
+     *
+     * A map read from a flatbuffer decodes its entries first, so the change is kept
+     */
+    pmt_sptr ref(const T& key)
+    {
+        release_buffer();
+        return at(key);
+    }
+
+    /**
+     * @brief Insert or replace one entry
+     *
+     * Only the in-memory map is touched; the flatbuffer encoding is rebuilt once, the
+     * next time it is needed
+     *
+     * @param key
+     * @param value
+     */
+    void set(const T& key, pmt_sptr value)
+    {
+        release_buffer();
+        _map[key] = value;
+        invalidate();
+    }
+
+protected:
+    bool equal_value(const pmt_base& other) const override
+    {
+        auto& lhs = entries();
+        auto& rhs = static_cast<const pmt_map<T>&>(other).entries();
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (auto it1 = lhs.begin(), it2 = rhs.begin(); it1 != lhs.end();
+             ++it1, ++it2) {
+            if (it1->first != it2->first || *it1->second != *it2->second) {
+                return false;
+            }
+        }
+        return true;
+    }
+    size_t compute_hash() const override;
+
+private:
+    /**
+     * @brief The native entries, decoded from the flatbuffer the first time they are
+     * needed
+     *
+     */
+    const std::map<T, pmt_sptr>& entries() const
+    {
+        if (_fb_map) {
+            std::call_once(_decoded, [this] { decode(); });
+        }
+        return _map;
+    }
+
+    /**
+     * @brief Switch to the native entries before a modification
+     *
+     */
+    void release_buffer()
+    {
+        if (_fb_map) {
+            entries();
+            _fb_map = nullptr;
+            _owner.reset();
+        }
+    }
+
+    void decode() const;
+    size_t fb_size() const;
+    const pmtf::Pmt* fb_lookup(const T& key) const;
+    bool fb_contains(const T& key) const;
+
+    mutable std::map<T, pmt_sptr> _map;
+    // Set while the entries are read from a flatbuffer, which _owner keeps alive
+    const MapString* _fb_map = nullptr;
+    std::shared_ptr<const void> _owner;
+    mutable std::once_flag _decoded;
 };
 
 } // namespace pmtf
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace pmtf {
+
+/**
+ * @brief Per-thread cache of small memory blocks for pmt objects
+ *
+ * Blocks are grouped in size classes and kept on a free list of the thread that released
+ * them, so the steady state of code that keeps creating and dropping small pmts (tags,
+ * message headers) does not go to the global allocator at all.  Blocks may be released
+ * on a different thread than the one that allocated them - they simply move to that
+ * thread's cache.  Each cache is bounded, and flushed when its thread exits.
+ */
+class pmt_pool
+{
+public:
+    static constexpr size_t granularity = 16;
+    static constexpr size_t max_block_size = 256;
+    static constexpr size_t max_cached_per_class = 1024;
+
+    static void* allocate(size_t size);
+    static void deallocate(void* p, size_t size);
+};
+
+/**
+ * @brief Standard allocator on top of pmt_pool, for use with std::allocate_shared
+ *
+ * @tparam T
+ */
+template <class T>
+class pool_allocator
+{
+public:
+    typedef T value_type;
+
+    pool_allocator() = default;
+    template <class U>
+    pool_allocator(const pool_allocator<U>&)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+                      "pool_allocator does not support over-aligned types");
+        return static_cast<T*>(pmt_pool::allocate(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) { pmt_pool::deallocate(p, n * sizeof(T)); }
+};
+
+template <class T, class U>
+bool operator==(const pool_allocator<T>&, const pool_allocator<U>&)
+{
+    return true;
+}
+template <class T, class U>
+bool operator!=(const pool_allocator<T>&, const pool_allocator<U>&)
+{
+    return false;
+}
+
+/**
+ * @brief make_shared for pmt objects - object and control block come from pmt_pool
+ *
+ */
+template <class T, class... Args>
+std::shared_ptr<T> make_pooled(Args&&... args)
+{
+    return std::allocate_shared<T>(pool_allocator<T>(), std::forward<Args>(args)...);
+}
+
+} // namespace pmtf
@@ -2,6 +2,7 @@
 
 #include <pmt/pmt_generated.h>
 #include <pmt/pmtf.hh>
+#include <pmt/pmtf_pool.hh>
 #include <complex>
 #include <iostream>
 #include <map>
@@ -17,24 +18,30 @@ class pmt_scalar : public pmt_base
 {
 public:
     typedef std::shared_ptr<pmt_scalar> sptr;
-    static sptr make(const T value) { return std::make_shared<pmt_scalar<T>>(value); }
+    static sptr make(const T value) { return make_pooled<pmt_scalar<T>>(value); }
     static sptr from_buffer(const uint8_t* buf)
     {
-        return std::make_shared<pmt_scalar<T>>(buf);
+        return make_pooled<pmt_scalar<T>>(buf);
     }
     static sptr from_pmt(const pmtf::Pmt* fb_pmt)
     {
-        return std::make_shared<pmt_scalar<T>>(fb_pmt);
+        return make_pooled<pmt_scalar<T>>(fb_pmt);
     }
 
-    void set_value(T val);
-    T value();
+    void set_value(T val)
+    {
+        _value = val;
+        invalidate();
+    }
+    T value() const { return _value; }
 
     void operator=(const T& other) // copy assignment
     {
         set_value(other);
     }
 
+    using pmt_base::operator==;
+    using pmt_base::operator!=;
     bool operator==(const T& other) { return other == value(); }
     bool operator!=(const T& other) { return other != value(); }
 
@@ -43,113 +50,88 @@ public:
     pmt_scalar(const T& val);
     pmt_scalar(const uint8_t* buf);
     pmt_scalar(const pmtf::Pmt* fb_pmt);
+
+protected:
+    // Compare and hash the bytes of the value, as the encoding would
+    bool equal_value(const pmt_base& other) const override
+    {
+        return !memcmp(
+            &_value, &static_cast<const pmt_scalar<T>&>(other)._value, sizeof(T));
+    }
+    size_t compute_hash() const override
+    {
+        return hash_bytes(&_value, sizeof(T), (size_t)data_type());
+    }
+
+private:
+    T _value; // encoded into the flatbuffer only when needed
 };
 
 
-#define IMPLEMENT_PMT_SCALAR(datatype, fbtype)                      \
-    template <>                                                     \
-    datatype pmt_scalar<datatype>::value()                          \
-    {                                                               \
-        auto pmt = GetSizePrefixedPmt(_fbb.GetBufferPointer());     \
-        return pmt->data_as_Scalar##fbtype()->value();              \
-    }                                                               \
-                                                                    \
-    template <>                                                     \
-    flatbuffers::Offset<void> pmt_scalar<datatype>::rebuild_data(   \
-        flatbuffers::FlatBufferBuilder& fbb)                        \
-    {                                                               \
-        Scalar##fbtype##Builder sb(fbb);                            \
-        auto val = value();                                         \
-        sb.add_value(val);                                          \
-        return sb.Finish().Union();                                 \
-    }                                                               \
-                                                                    \
-    template <>                                                     \
-    void pmt_scalar<datatype>::set_value(datatype val)              \
-    {                                                               \
-        Scalar##fbtype##Builder sb(_fbb);                           \
-        sb.add_value(val);                                          \
-        _data = sb.Finish().Union();                                \
-        build();                                                    \
-    }                                                               \
-                                                                    \
-    template <>                                                     \
-    pmt_scalar<datatype>::pmt_scalar(const datatype& val)           \
-        : pmt_base(Data::Scalar##fbtype)                            \
-    {                                                               \
-        set_value(val);                                             \
-    }                                                               \
-                                                                    \
-    template <>                                                     \
-    pmt_scalar<datatype>::pmt_scalar(const uint8_t* buf)            \
-        : pmt_base(Data::Scalar##fbtype)                            \
-    {                                                               \
-        auto data = GetPmt(buf)->data_as_Scalar##fbtype()->value(); \
-        set_value(data);                                            \
-    }                                                               \
-                                                                    \
-    template <>                                                     \
-    pmt_scalar<datatype>::pmt_scalar(const pmtf::Pmt* fb_pmt)       \
-        : pmt_base(Data::Scalar##fbtype)                            \
-    {                                                               \
-        auto data = fb_pmt->data_as_Scalar##fbtype()->value();      \
-        set_value(data);                                            \
-    }                                                               \
-                                                                    \
+#define IMPLEMENT_PMT_SCALAR(datatype, fbtype)                    \
+    template <>                                                   \
+    flatbuffers::Offset<void> pmt_scalar<datatype>::rebuild_data( \
+        flatbuffers::FlatBufferBuilder& fbb)                      \
+    {                                                             \
+        Scalar##fbtype##Builder sb(fbb);                          \
+        sb.add_value(_value);                                     \
+        return sb.Finish().Union();                               \
+    }                                                             \
+                                                                  \
+    template <>                                                   \
+    pmt_scalar<datatype>::pmt_scalar(const datatype& val)         \
+        : pmt_base(Data::Scalar##fbtype), _value(val)             \
+    {                                                             \
+    }                                                             \
+                                                                  \
+    template <>                                                   \
+    pmt_scalar<datatype>::pmt_scalar(const uint8_t* buf)          \
+        : pmt_base(Data::Scalar##fbtype),                         \
+          _value(GetPmt(buf)->data_as_Scalar##fbtype()->value())  \
+    {                                                             \
+    }                                                             \
+                                                                  \
+    template <>                                                   \
+    pmt_scalar<datatype>::pmt_scalar(const pmtf::Pmt* fb_pmt)     \
+        : pmt_base(Data::Scalar##fbtype),                         \
+          _value(fb_pmt->data_as_Scalar##fbtype()->value())       \
+    {                                                             \
+    }                                                             \
+                                                                  \
     template class pmt_scalar<datatype>;
 
 
-#define IMPLEMENT_PMT_SCALAR_CPLX(datatype, fbtype)                    \
-    template <>                                                        \
-    datatype pmt_scalar<datatype>::value()                             \
-    {                                                                  \
-        auto pmt = GetSizePrefixedPmt(_fbb.GetBufferPointer());        \
-        return *((datatype*)(pmt->data_as_Scalar##fbtype()->value())); \
-    }                                                                  \
-                                                                       \
-    template <>                                                        \
-    flatbuffers::Offset<void> pmt_scalar<datatype>::rebuild_data(      \
-        flatbuffers::FlatBufferBuilder& fbb)                           \
-    {                                                                  \
-        Scalar##fbtype##Builder sb(fbb);                               \
-        auto val = value();                                            \
-        sb.add_value((fbtype*)&val);                                   \
-        return sb.Finish().Union();                                    \
-    }                                                                  \
-                                                                       \
-    template <>                                                        \
-    void pmt_scalar<datatype>::set_value(datatype val)                 \
-    {                                                                  \
-        Scalar##fbtype##Builder sb(_fbb);                              \
-        sb.add_value((fbtype*)&val);                                   \
-        _data = sb.Finish().Union();                                   \
-        build();                                                       \
-    }                                                                  \
-                                                                       \
-    template <>                                                        \
-    pmt_scalar<datatype>::pmt_scalar(const datatype& val)              \
-        : pmt_base(Data::Scalar##fbtype)                               \
-    {                                                                  \
-        set_value(val);                                                \
-    }                                                                  \
-                                                                       \
-    template <>                                                        \
-    pmt_scalar<datatype>::pmt_scalar(const uint8_t* buf)               \
-        : pmt_base(Data::Scalar##fbtype)                               \
-    {                                                                  \
-        auto data = GetPmt(buf)->data_as_Scalar##fbtype()->value();    \
-        set_value(*((const datatype*)data));                           \
-    }                                                                  \
-                                                                       \
-    template <>                                                        \
-    pmt_scalar<datatype>::pmt_scalar(const pmtf::Pmt* fb_pmt)          \
-        : pmt_base(Data::Scalar##fbtype)                               \
-    {                                                                  \
-        auto data = fb_pmt->data_as_Scalar##fbtype()->value();         \
-        set_value(*((const datatype*)data));                           \
-    }                                                                  \
-                                                                       \
-                                                                       \
+#define IMPLEMENT_PMT_SCALAR_CPLX(datatype, fbtype)                                  \
+    template <>                                                                      \
+    flatbuffers::Offset<void> pmt_scalar<datatype>::rebuild_data(                    \
+        flatbuffers::FlatBufferBuilder& fbb)                                         \
+    {                                                                                \
+        Scalar##fbtype##Builder sb(fbb);                                             \
+        sb.add_value((const fbtype*)&_value);                                        \
+        return sb.Finish().Union();                                                  \
+    }                                                                                \
+                                                                                     \
+    template <>                                                                      \
+    pmt_scalar<datatype>::pmt_scalar(const datatype& val)                            \
+        : pmt_base(Data::Scalar##fbtype), _value(val)                                \
+    {                                                                                \
+    }                                                                                \
+                                                                                     \
+    template <>                                                                      \
+    pmt_scalar<datatype>::pmt_scalar(const uint8_t* buf)                             \
+        : pmt_base(Data::Scalar##fbtype),                                            \
+          _value(*((const datatype*)GetPmt(buf)->data_as_Scalar##fbtype()->value())) \
+    {                                                                                \
+    }                                                                                \
+                                                                                     \
+    template <>                                                                      \
+    pmt_scalar<datatype>::pmt_scalar(const pmtf::Pmt* fb_pmt)                        \
+        : pmt_base(Data::Scalar##fbtype),                                            \
+          _value(*((const datatype*)fb_pmt->data_as_Scalar##fbtype()->value()))      \
+    {                                                                                \
+    }                                                                                \
+                                                                                     \
+                                                                                     \
     template class pmt_scalar<datatype>;
 
 } // namespace pmtf
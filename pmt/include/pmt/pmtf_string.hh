@@ -2,10 +2,12 @@
 
 #include <pmt/pmt_generated.h>
 #include <pmt/pmtf.hh>
+#include <pmt/pmtf_pool.hh>
 #include <complex>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <string>
 #include <typeindex>
 #include <typeinfo>
 
@@ -18,26 +20,43 @@ public:
     typedef std::shared_ptr<pmt_string> sptr;
     static sptr make(const std::string& value)
     {
-        return std::make_shared<pmt_string>(value);
+        return make_pooled<pmt_string>(value);
     }
     static sptr from_buffer(const uint8_t* buf)
     {
-        return std::make_shared<pmt_string>(buf);
+        return make_pooled<pmt_string>(buf);
     }
     static sptr from_pmt(const pmtf::Pmt *fb_pmt)
     {
-        return std::make_shared<pmt_string>(fb_pmt);
+        return make_pooled<pmt_string>(fb_pmt);
     }
 
+    /**
+     * @brief Return the interned (symbol) pmt for a string
+     *
+     * All calls with the same string return the same shared object, so interned pmts
+     * can be created once, compared by pointer and hashed by address - as is done for
+     * tag keys and source ids.  Interned pmts live for the life of the process and are
+     * immutable: set_value() on one throws.
+     *
+     * @param value
+     * @return sptr
+     */
+    static sptr intern(const std::string& value);
+
+    bool interned() const { return _interned; }
+
 
     void set_value(const std::string& val);
-    std::string value();
+    const std::string& value() const { return _value; }
 
     void operator=(const std::string& other) // copy assignment
     {
         set_value(other);
     }
 
+    using pmt_base::operator==;
+    using pmt_base::operator!=;
     bool operator==(const std::string& other) { return other == value(); }
     bool operator!=(const std::string& other) { return other != value(); }
 
@@ -46,6 +65,20 @@ public:
     pmt_string(const std::string& val);
     pmt_string(const uint8_t* buf);
     pmt_string(const pmtf::Pmt *fb_pmt);
+
+protected:
+    bool equal_value(const pmt_base& other) const override
+    {
+        return _value == static_cast<const pmt_string&>(other)._value;
+    }
+    size_t compute_hash() const override
+    {
+        return hash_bytes(_value.data(), _value.size(), (size_t)data_type());
+    }
+
+private:
+    std::string _value; // encoded into the flatbuffer only when needed
+    bool _interned = false;
 };
 
 
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include <pmt/pmtf.hh>
+#include <pmt/pmtf_pool.hh>
 
 namespace pmtf {
 
@@ -21,19 +22,36 @@ public:
     typedef std::shared_ptr<pmt_vector> sptr;
     static sptr make(const std::vector<T>& val)
     {
-        return std::make_shared<pmt_vector<T>>(val);
+        return make_pooled<pmt_vector<T>>(val);
     }
     static sptr make(const T* data, size_t len)
     {
-        return std::make_shared<pmt_vector<T>>(data, len);
+        return make_pooled<pmt_vector<T>>(data, len);
+    }
+    /**
+     * @brief Make a vector of n zeroed elements whose length never changes
+     *
+     * The flatbuffer is allocated here once; set_value() and operator= then copy the new
+     * elements over the old ones, so updating and re-posting the vector (e.g. one
+     * spectrum frame per work call) costs a memcpy of the payload.  Assigning a value of
+     * a different length throws.
+     *
+     * @param n
+     * @return sptr
+     */
+    static sptr make_fixed(size_t n)
+    {
+        auto p = make_pooled<pmt_vector<T>>(std::vector<T>(n));
+        p->_fixed = true;
+        return p;
     }
     static sptr from_buffer(const uint8_t* buf)
     {
-        return std::make_shared<pmt_vector<T>>(buf);
+        return make_pooled<pmt_vector<T>>(buf);
     }
     static sptr from_pmt(const pmtf::Pmt* fb_pmt)
     {
-        return std::make_shared<pmt_vector<T>>(fb_pmt);
+        return make_pooled<pmt_vector<T>>(fb_pmt);
     }
 
 
@@ -58,8 +76,16 @@ public:
     pmt_vector(const uint8_t* buf);
     pmt_vector(const pmtf::Pmt* fb_pmt);
 
+    /**
+     * @brief Replace the elements
+     *
+     * A value of the current length is copied over the existing elements in place;
+     * other lengths rebuild the flatbuffer (and throw for make_fixed() vectors)
+     *
+     */
     void set_value(const std::vector<T>& val);
     void set_value(const T* data, size_t len);
+    bool fixed() const { return _fixed; }
     // void deserialize(std::streambuf& sb) override;
     std::vector<T> value() const; // returns a copy of the data stored in the flatbuffer
     const T* data();
@@ -70,23 +96,157 @@ public:
         set_value(other);
     }
 
+    using pmt_base::operator==;
+    using pmt_base::operator!=;
     bool operator==(const std::vector<T>& other) { return other == value(); }
     bool operator!=(const std::vector<T>& other) { return other != value(); }
 
     T ref(size_t k);           // overload operator []
     void set(size_t k, T val); // overload [] =
+    /**
+     * @brief Pointer for writing the elements in place
+     *
+     * Drops the cached hash, so get the pointer again for writes made after the pmt was
+     * hashed or compared
+     *
+     * @return T*
+     */
     T* writable_elements();
     const T* elements();
 
     flatbuffers::Offset<void> rebuild_data(flatbuffers::FlatBufferBuilder& fbb);
+
+private:
+    bool _fixed = false;
 };
 
+/**
+ * @brief A list of pmts of any type
+ *
+ * The list holds references to its elements rather than copies, so building one out of
+ * existing pmts (e.g. a batch of PDUs) does not touch their data.  When the list is
+ * serialized, elements that are already encoded - vectors always are - are spliced in
+ * as they are instead of being encoded again.
+ *
+ * Like the encoding, the hash is a snapshot: elements changed in place after they were
+ * put in the list are not seen until the list itself is updated
+ */
+template <>
+class pmt_vector<pmt_sptr> : public pmt_base
+{
+public:
+    typedef std::shared_ptr<pmt_vector> sptr;
+    typedef std::vector<pmt_sptr>::const_iterator const_iterator;
+    static sptr make(const std::vector<pmt_sptr>& val)
+    {
+        return make_pooled<pmt_vector<pmt_sptr>>(val);
+    }
+    static sptr from_buffer(const uint8_t* buf, size_t size)
+    {
+        return make_pooled<pmt_vector<pmt_sptr>>(buf, size);
+    }
+    static sptr from_pmt(const pmtf::Pmt* fb_pmt)
+    {
+        return make_pooled<pmt_vector<pmt_sptr>>(fb_pmt);
+    }
+
+    /**
+     * @brief Construct a new pmt list sharing the given pmts
+     *
+     * @param val
+     */
+    pmt_vector(const std::vector<pmt_sptr>& val);
+    /**
+     * @brief Construct a new pmt list from a serialized flatbuffer
+     *
+     * @param buf
+     * @param size
+     */
+    pmt_vector(const uint8_t* buf, size_t size);
+    pmt_vector(const pmtf::Pmt* fb_pmt);
+
+    void set_value(const std::vector<pmt_sptr>& val)
+    {
+        for (auto& p : val) {
+            check_element(p);
+        }
+        _value = val;
+        invalidate();
+    }
+    const std::vector<pmt_sptr>& value() const { return _value; }
+    size_t size() const { return _value.size(); }
+
+    void operator=(const std::vector<pmt_sptr>& other) { set_value(other); }
+
+    using pmt_base::operator==;
+    using pmt_base::operator!=;
+
+    pmt_sptr ref(size_t k) const
+    {
+        if (k >= _value.size())
+            throw std::runtime_error("PMT Vector index out of range");
+        return _value[k];
+    }
+    void set(size_t k, pmt_sptr val)
+    {
+        if (k >= _value.size())
+            throw std::runtime_error("PMT Vector index out of range");
+        _value[k] = check_element(val);
+        invalidate();
+    }
+    void push_back(pmt_sptr val)
+    {
+        _value.push_back(check_element(val));
+        invalidate();
+    }
+
+    const_iterator begin() const { return _value.begin(); }
+    const_iterator end() const { return _value.end(); }
+
+    flatbuffers::Offset<void> rebuild_data(flatbuffers::FlatBufferBuilder& fbb) override;
+
+protected:
+    bool equal_value(const pmt_base& other) const override
+    {
+        auto& rhs = static_cast<const pmt_vector<pmt_sptr>&>(other)._value;
+        if (_value.size() != rhs.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < _value.size(); i++) {
+            if (*_value[i] != *rhs[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    size_t compute_hash() const override;
+
+private:
+    static const pmt_sptr& check_element(const pmt_sptr& p)
+    {
+        if (!p)
+            throw std::runtime_error("PMT Vector element is null");
+        return p;
+    }
+
+    std::vector<pmt_sptr> _value;
+};
+
+typedef pmt_vector<pmt_sptr> pmt_list;
+
 
 typedef std::function<std::shared_ptr<pmt_base>(uint8_t*)> pmt_from_buffer_function;
 
 
 #define IMPLEMENT_PMT_VECTOR(datatype, fbtype)                                        \
     template <>                                                                       \
+    size_t pmt_vector<datatype>::size();                                              \
+    template <>                                                                       \
+    datatype* pmt_vector<datatype>::writable_elements();                              \
+    template <>                                                                       \
+    void pmt_vector<datatype>::set_value(const datatype* data, size_t len);           \
+                                                                                      \
+    template <>                                                                       \
     flatbuffers::Offset<void> pmt_vector<datatype>::rebuild_data(                     \
         flatbuffers::FlatBufferBuilder& fbb)                                          \
     {                                                                                 \
@@ -102,23 +262,27 @@ typedef std::function<std::shared_ptr<pmt_base>(uint8_t*)> pmt_from_buffer_funct
     template <>                                                                       \
     void pmt_vector<datatype>::set_value(const std::vector<datatype>& val)            \
     {                                                                                 \
-        _fbb.Reset();                                                                 \
-        auto vec = _fbb.CreateVector(val.data(), val.size());                         \
-        Vector##fbtype##Builder vb(_fbb);                                             \
-        vb.add_value(vec);                                                            \
-        _data = vb.Finish().Union();                                                  \
-        build();                                                                      \
+        set_value(val.data(), val.size());                                            \
     }                                                                                 \
                                                                                       \
     template <>                                                                       \
     void pmt_vector<datatype>::set_value(const datatype* data, size_t len)            \
     {                                                                                 \
-        _fbb.Reset();                                                                 \
-        auto vec = _fbb.CreateVector(data, len);                                      \
-        Vector##fbtype##Builder vb(_fbb);                                             \
+        if (_buf && size() == len) {                                                  \
+            /* same length: overwrite in place instead of rebuilding */               \
+            if (len)                                                                  \
+                memmove(writable_elements(), data, len * sizeof(datatype));           \
+            return;                                                                   \
+        }                                                                             \
+        if (_fixed)                                                                   \
+            throw std::runtime_error("PMT Vector is fixed size");                     \
+        builder().Reset();                                                            \
+        auto vec = builder().CreateVector(data, len);                                 \
+        Vector##fbtype##Builder vb(builder());                                        \
         vb.add_value(vec);                                                            \
         _data = vb.Finish().Union();                                                  \
         build();                                                                      \
+        invalidate_hash();                                                            \
     }                                                                                 \
                                                                                       \
     template <>                                                                       \
@@ -198,6 +362,7 @@ typedef std::function<std::shared_ptr<pmt_base>(uint8_t*)> pmt_from_buffer_funct
         if (k >= fb_vec->size())                                                      \
             throw std::runtime_error("PMT Vector index out of range");                \
         fb_vec->Mutate(k, val);                                                       \
+        invalidate_hash();                                                            \
     }                                                                                 \
     template <>                                                                       \
     const datatype* pmt_vector<datatype>::elements()                                  \
@@ -209,6 +374,7 @@ typedef std::function<std::shared_ptr<pmt_base>(uint8_t*)> pmt_from_buffer_funct
     template <>                                                                       \
     datatype* pmt_vector<datatype>::writable_elements()                               \
     {                                                                                 \
+        invalidate_hash();                                                            \
         auto pmt =                                                                    \
             GetMutablePmt(buffer_pointer() + 4); /* assuming size prefix is 32 bit */ \
         return (datatype*)(((pmtf::Vector##fbtype*)pmt->mutable_data())               \
@@ -219,6 +385,13 @@ typedef std::function<std::shared_ptr<pmt_base>(uint8_t*)> pmt_from_buffer_funct
 
 #define IMPLEMENT_PMT_VECTOR_CPLX(datatype, fbtype)                                     \
     template <>                                                                         \
+    size_t pmt_vector<datatype>::size();                                                \
+    template <>                                                                         \
+    datatype* pmt_vector<datatype>::writable_elements();                                \
+    template <>                                                                         \
+    void pmt_vector<datatype>::set_value(const datatype* data, size_t len);             \
+                                                                                        \
+    template <>                                                                         \
     flatbuffers::Offset<void> pmt_vector<datatype>::rebuild_data(                       \
         flatbuffers::FlatBufferBuilder& fbb)                                            \
     {                                                                                   \
@@ -232,23 +405,27 @@ typedef std::function<std::shared_ptr<pmt_base>(uint8_t*)> pmt_from_buffer_funct
     template <>                                                                         \
     void pmt_vector<datatype>::set_value(const std::vector<datatype>& val)              \
     {                                                                                   \
-        _fbb.Reset();                                                                   \
-        auto vec =                                                                      \
-            _fbb.CreateVectorOfNativeStructs<fbtype, datatype>(val.data(), val.size()); \
-        Vector##fbtype##Builder vb(_fbb);                                               \
-        vb.add_value(vec);                                                              \
-        _data = vb.Finish().Union();                                                    \
-        build();                                                                        \
+        set_value(val.data(), val.size());                                              \
     }                                                                                   \
+                                                                                        \
     template <>                                                                         \
     void pmt_vector<datatype>::set_value(const datatype* data, size_t len)              \
     {                                                                                   \
-        _fbb.Reset();                                                                   \
-        auto vec = _fbb.CreateVectorOfNativeStructs<fbtype, datatype>(data, len);       \
-        Vector##fbtype##Builder vb(_fbb);                                               \
+        if (_buf && size() == len) {                                                    \
+            /* same length: overwrite in place instead of rebuilding */                 \
+            if (len)                                                                    \
+                memmove(writable_elements(), data, len * sizeof(datatype));             \
+            return;                                                                     \
+        }                                                                               \
+        if (_fixed)                                                                     \
+            throw std::runtime_error("PMT Vector is fixed size");                       \
+        builder().Reset();                                                              \
+        auto vec = builder().CreateVectorOfNativeStructs<fbtype, datatype>(data, len);  \
+        Vector##fbtype##Builder vb(builder());                                          \
         vb.add_value(vec);                                                              \
         _data = vb.Finish().Union();                                                    \
         build();                                                                        \
+        invalidate_hash();                                                              \
     }                                                                                   \
     template <>                                                                         \
     pmt_vector<datatype>::pmt_vector(const std::vector<datatype>& val)                  \
@@ -330,10 +507,12 @@ typedef std::function<std::shared_ptr<pmt_base>(uint8_t*)> pmt_from_buffer_funct
         if (k >= fb_vec->size())                                                        \
             throw std::runtime_error("PMT Vector index out of range");                  \
         fb_vec->Mutate(k, (fbtype*)&val); /* hacky cast */                              \
+        invalidate_hash();                                                              \
     }                                                                                   \
     template <>                                                                         \
     datatype* pmt_vector<datatype>::writable_elements()                                 \
     {                                                                                   \
+        invalidate_hash();                                                              \
         auto pmt =                                                                      \
             GetMutablePmt(buffer_pointer() + 4); /* assuming size prefix is 32 bit */   \
         auto mutable_obj = ((pmtf::Vector##fbtype*)pmt->mutable_data())                 \
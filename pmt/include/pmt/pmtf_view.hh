@@ -0,0 +1,165 @@
+#pragma once
+
+#include <pmt/pmt_generated.h>
+#include <pmt/pmtf.hh>
+#include <complex>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace pmtf {
+
+/**
+ * @brief Read-only typed view of the elements of a serialized pmt vector
+ *
+ * Points directly into the flatbuffer the view was made from
+ *
+ * @tparam T
+ */
+template <class T>
+class pmt_vector_view
+{
+public:
+    pmt_vector_view(const T* data, size_t size, std::shared_ptr<const void> owner)
+        : _data(data), _size(size), _owner(owner)
+    {
+    }
+
+    const T* data() const { return _data; }
+    size_t size() const { return _size; }
+    const T* begin() const { return _data; }
+    const T* end() const { return _data + _size; }
+
+    T ref(size_t k) const
+    {
+        if (k >= _size)
+            throw std::runtime_error("PMT Vector index out of range");
+        return _data[k];
+    }
+    const T& operator[](size_t k) const { return _data[k]; }
+
+private:
+    const T* _data;
+    size_t _size;
+    std::shared_ptr<const void> _owner;
+};
+
+/**
+ * @brief Read-only view of a serialized pmt
+ *
+ * Wraps a flatbuffer that lives somewhere else - a received message, a buffer shared
+ * between blocks - and reads values straight out of it instead of copying it into a new
+ * pmt object.  The buffer is verified once on construction, so accessors never read
+ * outside of it.
+ *
+ * The bytes must stay valid for as long as the view (and any view derived from it) is
+ * used.  Pass an owner to have the view keep a reference counted buffer alive.
+ */
+class pmt_view
+{
+public:
+    /**
+     * @brief Largest pmt deserialize() accepts unless told otherwise
+     *
+     */
+    static constexpr size_t default_max_size = 16 * 1024 * 1024;
+
+    pmt_view() = default;
+
+    /**
+     * @brief Construct a view of a serialized pmt without copying it
+     *
+     * @param buf start of the flatbuffer (after the size prefix written by serialize())
+     * @param size number of valid bytes at buf
+     * @param owner optional reference to whatever keeps buf alive
+     */
+    pmt_view(const uint8_t* buf, size_t size, std::shared_ptr<const void> owner = nullptr);
+
+    /**
+     * @brief View of a pmt that still carries the size prefix written by serialize()
+     *
+     * Flatbuffers align their contents relative to the whole (prefixed) buffer, so this
+     * is the form to keep received pmts in
+     *
+     * @param buf start of the size prefix
+     * @param size number of valid bytes at buf, including the prefix
+     * @param owner optional reference to whatever keeps buf alive
+     * @return pmt_view
+     */
+    static pmt_view size_prefixed(const uint8_t* buf,
+                                  size_t size,
+                                  std::shared_ptr<const void> owner = nullptr);
+
+    /**
+     * @brief Read one size prefixed pmt, as written by pmt_base::serialize, from a stream
+     *
+     * The payload is read into a single heap buffer owned by the returned view.  Throws
+     * if the stream ends early, the size prefix exceeds max_size, or the payload is not a
+     * valid pmt.
+     *
+     * @param sb
+     * @param max_size
+     * @return pmt_view
+     */
+    static pmt_view deserialize(std::streambuf& sb, size_t max_size = default_max_size);
+
+    bool valid() const { return _pmt != nullptr; }
+    Data data_type() const;
+    const Pmt* fb() const { return _pmt; }
+
+    template <class T>
+    T scalar() const;
+
+    template <class T>
+    pmt_vector_view<T> vector() const;
+
+    std::string_view string() const;
+
+    /**
+     * @brief Look up a key in a serialized map
+     *
+     * Uses the sorted keys of the flatbuffer, and the returned view shares this view's
+     * buffer
+     *
+     * @param key
+     * @return pmt_view
+     */
+    pmt_view ref(const std::string& key) const;
+    bool contains(const std::string& key) const;
+    size_t map_size() const;
+
+    /**
+     * @brief Element of a serialized list (pmt_vector<pmt_sptr>), sharing this view's
+     * buffer
+     *
+     * @param k
+     * @return pmt_view
+     */
+    pmt_view list_ref(size_t k) const;
+    size_t list_size() const;
+
+    /**
+     * @brief Copy the viewed value into a regular (owning, mutable) pmt
+     *
+     * If the view has an owner, a map shares it and keeps reading its entries from this
+     * buffer until it is first modified
+     *
+     * @return pmt_sptr
+     */
+    pmt_sptr to_pmt() const;
+
+private:
+    pmt_view(const Pmt* pmt, std::shared_ptr<const void> owner)
+        : _pmt(pmt), _owner(owner)
+    {
+    }
+
+    const MapEntryString* lookup(const std::string& key) const;
+    const flatbuffers::Vector<flatbuffers::Offset<Pmt>>* list() const;
+
+    const Pmt* _pmt = nullptr;
+    std::shared_ptr<const void> _owner;
+};
+
+} // namespace pmtf
@@ -1,8 +1,11 @@
 #include <pmt/pmtf.hh>
+#include <pmt/pmtf_map.hh>
 #include <pmt/pmtf_scalar.hh>
 #include <pmt/pmtf_string.hh>
 #include <pmt/pmtf_vector.hh>
+#include <pmt/pmtf_view.hh>
 #include <map>
+#include <thread>
 
 namespace flatbuffers {
 pmtf::Complex64 Pack(const std::complex<float>& obj)
@@ -50,6 +53,12 @@ pmt_base::sptr pmt_base::from_pmt(const pmtf::Pmt* fb_pmt)
         return std::static_pointer_cast<pmt_base>(pmt_scalar<int64_t>::from_pmt(fb_pmt));
     case Data::ScalarUInt64:
         return std::static_pointer_cast<pmt_base>(pmt_scalar<uint64_t>::from_pmt(fb_pmt));
+    case Data::ScalarFloat32:
+        return std::static_pointer_cast<pmt_base>(pmt_scalar<float>::from_pmt(fb_pmt));
+    case Data::ScalarFloat64:
+        return std::static_pointer_cast<pmt_base>(pmt_scalar<double>::from_pmt(fb_pmt));
+    case Data::ScalarBool:
+        return std::static_pointer_cast<pmt_base>(pmt_scalar<bool>::from_pmt(fb_pmt));
     case Data::VectorInt8:
         return std::static_pointer_cast<pmt_base>(pmt_vector<int8_t>::from_pmt(fb_pmt));
     case Data::VectorUInt8:
@@ -72,6 +81,10 @@ pmt_base::sptr pmt_base::from_pmt(const pmtf::Pmt* fb_pmt)
         return std::static_pointer_cast<pmt_base>(pmt_vector<double>::from_pmt(fb_pmt));
     case Data::VectorComplex64:
         return std::static_pointer_cast<pmt_base>(pmt_vector<std::complex<float>>::from_pmt(fb_pmt));
+    case Data::VectorPmt:
+        return std::static_pointer_cast<pmt_base>(pmt_vector<pmt_sptr>::from_pmt(fb_pmt));
+    case Data::MapString:
+        return std::static_pointer_cast<pmt_base>(pmt_map<std::string>::from_pmt(fb_pmt));
     // case Data::VectorComplex128:
     //     return std::static_pointer_cast<pmt_base>(pmt_vector<std::complex<double>>::from_pmt(fb_pmt));
 
@@ -80,10 +93,83 @@ pmt_base::sptr pmt_base::from_pmt(const pmtf::Pmt* fb_pmt)
     }
 }
 
+pmt_base::sptr pmt_base::from_pmt(const pmtf::Pmt* fb_pmt,
+                                  std::shared_ptr<const void> owner)
+{
+    if (owner && fb_pmt->data_type() == Data::MapString) {
+        return std::static_pointer_cast<pmt_base>(
+            pmt_map<std::string>::from_pmt(fb_pmt, owner));
+    }
+    return from_pmt(fb_pmt);
+}
+
+void pmt_base::encode() const
+{
+    auto state = _encode_state.load(std::memory_order_acquire);
+    while (state != ENCODED) {
+        if (state == STALE &&
+            _encode_state.compare_exchange_weak(state, ENCODING, std::memory_order_acquire)) {
+            // The encoding is a cache of the native value, so refreshing it does not
+            // change the observable state of the pmt.  build() publishes it as ENCODED.
+            auto self = const_cast<pmt_base*>(this);
+            try {
+                self->builder().Reset();
+                self->_data = self->rebuild_data(self->builder());
+            } catch (...) {
+                _encode_state.store(STALE, std::memory_order_release);
+                throw;
+            }
+            self->build();
+            return;
+        }
+        if (state == ENCODING) {
+            // Another reader is encoding this pmt - only ever for as long as one
+            // rebuild takes
+            std::this_thread::yield();
+            state = _encode_state.load(std::memory_order_acquire);
+        }
+    }
+}
+
+flatbuffers::Offset<Pmt> pmt_base::splice(flatbuffers::FlatBufferBuilder& fbb)
+{
+    // Encoding only waits on this pmt, so a child can be encoded from inside its
+    // parent's encode, and the encoding stays cached for the next time it is spliced
+    encode();
+
+    // The encoding is a finished buffer whose contents only refer to each other by
+    // relative offsets and are aligned relative to its end.  Placing that end on an
+    // alignment boundary of fbb keeps every field aligned, and the root offset gives
+    // the position of the Pmt table within the copied bytes.
+    const size_t prefix_size = sizeof(flatbuffers::uoffset_t);
+    auto buf = _fbb->GetBufferPointer() + prefix_size;
+    size_t len = _fbb->GetSize() - prefix_size;
+    auto root = flatbuffers::ReadScalar<flatbuffers::uoffset_t>(buf);
+
+    fbb.Align(sizeof(uint64_t)); // largest scalar in the schema
+    fbb.PushBytes(buf, len);
+    return flatbuffers::Offset<Pmt>(fbb.GetSize() - root);
+}
+
 pmt_base::sptr pmt_base::from_buffer(const uint8_t* buf, size_t size)
 {
-    auto PMT = GetPmt(buf);
-    return from_pmt(PMT);
+    pmt_view view(buf, size);
+    if (view.data_type() == Data::MapString) {
+        // Maps read from a copy of the buffer instead of decoding it here
+        return std::static_pointer_cast<pmt_base>(
+            pmt_map<std::string>::from_buffer(buf, size));
+    }
+    return view.to_pmt();
+}
+
+pmt_base::sptr pmt_base::deserialize(std::streambuf& sb)
+{
+    return deserialize(sb, pmt_view::default_max_size);
+}
+
+pmt_base::sptr pmt_base::deserialize(std::streambuf& sb, size_t max_size)
+{
+    return pmt_view::deserialize(sb, max_size).to_pmt();
 }
 
 template class pmt_scalar<std::complex<float>>;
@@ -0,0 +1,134 @@
+#include <pmt/pmtf_batch.hh>
+#include <flatbuffers/flatbuffers.h>
+#include <cstring>
+#include <stdexcept>
+
+namespace pmtf {
+
+namespace {
+constexpr size_t field_size = sizeof(uint32_t);
+constexpr size_t header_size = 2 * field_size; // frame_size and count
+constexpr size_t entry_size = 2 * field_size;  // offset and size
+} // namespace
+
+void pmt_batch_writer::clear()
+{
+    _count = 0;
+    _header.resize(header_size);
+    _payload.clear();
+}
+
+void pmt_batch_writer::add(const pmt_base& p)
+{
+    auto offset = _payload.size();
+    auto size = p.size();
+    if (offset + size > UINT32_MAX) {
+        throw std::runtime_error("PMT batch frame too large");
+    }
+
+    auto idx = _header.size();
+    _header.resize(idx + entry_size);
+    flatbuffers::WriteScalar<uint32_t>(&_header[idx], offset);
+    flatbuffers::WriteScalar<uint32_t>(&_header[idx + field_size], size);
+
+    // Pad so the next pmt starts aligned too
+    auto padded = (size + alignment - 1) & ~(alignment - 1);
+    _payload.resize(offset + padded);
+    memcpy(&_payload[offset], p.buffer_pointer(), size);
+    memset(&_payload[offset + size], 0, padded - size);
+    _count++;
+}
+
+bool pmt_batch_writer::write(std::streambuf& sb)
+{
+    flatbuffers::WriteScalar<uint32_t>(&_header[0], frame_size() - field_size);
+    flatbuffers::WriteScalar<uint32_t>(&_header[field_size], _count);
+
+    bool ret = sb.sputn((const char*)_header.data(), _header.size()) ==
+               (std::streamsize)_header.size();
+    if (ret && !_payload.empty()) {
+        ret = sb.sputn((const char*)_payload.data(), _payload.size()) ==
+              (std::streamsize)_payload.size();
+    }
+
+    clear();
+    return ret;
+}
+
+pmt_batch_reader::pmt_batch_reader(const uint8_t* frame,
+                                   size_t size,
+                                   std::shared_ptr<const void> owner)
+    : _owner(owner)
+{
+    parse(frame, size);
+}
+
+void pmt_batch_reader::parse(const uint8_t* frame, size_t size)
+{
+    if (size < header_size) {
+        throw std::runtime_error("Truncated PMT batch header");
+    }
+    size_t frame_size = flatbuffers::ReadScalar<uint32_t>(frame);
+    size_t count = flatbuffers::ReadScalar<uint32_t>(frame + field_size);
+    if (frame_size < field_size || frame_size + field_size > size ||
+        (frame_size - field_size) / entry_size < count) {
+        throw std::runtime_error("Malformed PMT batch header");
+    }
+
+    _count = count;
+    _index = frame + header_size;
+    _payload = _index + count * entry_size;
+    _payload_size = frame_size + field_size - header_size - count * entry_size;
+}
+
+bool pmt_batch_reader::read(std::streambuf& sb, size_t max_size)
+{
+    _count = 0;
+    _owner.reset();
+
+    uint8_t prefix[field_size];
+    auto n = sb.sgetn((char*)prefix, field_size);
+    if (n == 0) {
+        return false;
+    }
+    if (n != (std::streamsize)field_size) {
+        throw std::runtime_error("Truncated PMT batch header");
+    }
+    size_t frame_size = flatbuffers::ReadScalar<uint32_t>(prefix);
+    if (frame_size + field_size > max_size) {
+        throw std::runtime_error("PMT batch frame too large: " +
+                                 std::to_string(frame_size));
+    }
+
+    // Views from the previous frame may still point into the buffer
+    if (!_frame || _frame.use_count() > 1) {
+        _frame = std::make_shared<std::vector<uint8_t>>();
+    }
+    _frame->resize(frame_size + field_size);
+    memcpy(_frame->data(), prefix, field_size);
+    if (sb.sgetn((char*)_frame->data() + field_size, frame_size) !=
+        (std::streamsize)frame_size) {
+        throw std::runtime_error("Truncated PMT batch frame");
+    }
+
+    _owner = _frame;
+    parse(_frame->data(), _frame->size());
+    return true;
+}
+
+pmt_view pmt_batch_reader::view(size_t k) const
+{
+    if (k >= _count) {
+        throw std::runtime_error("PMT batch index out of range");
+    }
+    size_t offset = flatbuffers::ReadScalar<uint32_t>(_index + k * entry_size);
+    size_t size = flatbuffers::ReadScalar<uint32_t>(_index + k * entry_size + field_size);
+    if (offset > _payload_size || size > _payload_size - offset ||
+        offset % pmt_batch_writer::alignment) {
+        throw std::runtime_error("Malformed PMT batch index");
+    }
+
+    return pmt_view::size_prefixed(_payload + offset, size, _owner);
+}
+
+} // namespace pmtf
@@ -1,5 +1,7 @@
 #include <pmt/pmtf_map.hh>
+#include <pmt/pmtf_view.hh>
 #include <map>
+#include <vector>
 #include <flatbuffers/flatbuffers.h>
 
 namespace pmtf {
@@ -7,83 +9,116 @@ namespace pmtf {
 template <>
 flatbuffers::Offset<void> pmt_map<std::string>::rebuild_data(flatbuffers::FlatBufferBuilder& fbb)
 {
-    throw std::runtime_error("This should not get called");
-}
+    auto& map = this->entries();
+    std::vector<flatbuffers::Offset<MapEntryString>> entries;
+    entries.reserve(map.size());
 
-template <>
-std::map<std::string, pmt_sptr> pmt_map<std::string>::value() const
-{
-    std::map<std::string, pmt_sptr> ret;
-    auto pmt = GetSizePrefixedPmt(_buf);
-    auto entries = pmt->data_as_MapString()->entries();
-    for (size_t k=0; k<entries->size(); k++)
+    for( auto const& [key, val] : map )
     {
-        ret[entries->Get(k)->key()->str()] = pmt_base::from_pmt(entries->Get(k)->value());       
+        auto str = fbb.CreateString(key);
+        auto pmt_offset = val->splice(fbb);
+        entries.push_back(CreateMapEntryString(fbb, str, pmt_offset ));
     }
 
-    return ret;
+    auto vec = fbb.CreateVectorOfSortedTables(&entries);
+    MapStringBuilder mb(fbb);
+    mb.add_entries(vec);
+    return mb.Finish().Union();
 }
 
 template <>
-void pmt_map<std::string>::set_value(const std::map<std::string,pmt_sptr>& map_in)
+size_t pmt_map<std::string>::compute_hash() const
 {
-    _fbb.Reset();
-    std::vector<flatbuffers::Offset<MapEntryString>> entries;
-
-    for( auto const& [key, val] : map_in )
-    {
-        auto str = _fbb.CreateString(key.c_str());
-        auto pmt_offset = val->build(_fbb);
-        entries.push_back(CreateMapEntryString(_fbb, str, pmt_offset ));
+    // Like the encoding, this is a snapshot: values changed in place after they were
+    // put in the map are not seen until the map itself is updated
+    size_t h = hash_bytes(nullptr, 0, (size_t)data_type());
+    for (auto const& [key, val] : entries()) {
+        h = hash_bytes(key.data(), key.size(), h);
+        h = hash_bytes(&h, sizeof(h), val->hash());
     }
-
-    auto vec = _fbb.CreateVectorOfSortedTables(&entries);
-    MapStringBuilder mb(_fbb);
-    mb.add_entries(vec);
-    _data = mb.Finish().Union();
-    build();
+    return h;
 }
 
 template <>
-pmt_map<std::string>::pmt_map(const std::map<std::string,pmt_sptr>& val)
-    : pmt_base(Data::MapString)
+void pmt_map<std::string>::decode() const
 {
-    set_value(val);
+    auto entries = _fb_map->entries();
+    if (!entries) {
+        return;
+    }
+    for (auto e : *entries) {
+        if (!e->value()) {
+            throw std::runtime_error("Map entry without a value");
+        }
+        // entries are stored sorted, so each insert goes at the end
+        _map.emplace_hint(
+            _map.end(), e->key()->str(), pmt_base::from_pmt(e->value(), _owner));
+    }
 }
 
 template <>
-pmt_map<std::string>::pmt_map(const uint8_t* buf, size_t size) 
-    : pmt_base(Data::MapString)
+size_t pmt_map<std::string>::fb_size() const
 {
-    set_buffer(buf, size);
+    auto entries = _fb_map->entries();
+    return entries ? entries->size() : 0;
 }
 
 template <>
-pmt_sptr pmt_map<std::string>::ref(const std::string& str)
+const pmtf::Pmt* pmt_map<std::string>::fb_lookup(const std::string& key) const
 {
-    auto pmt = GetSizePrefixedPmt(_buf);
-    auto entries = pmt->data_as_MapString()->entries();
-    auto ptr = entries->LookupByKey(str.c_str()); // should return flatbuffers::Offset<pmtf::MapEntryString>
-    if (ptr == nullptr)
-    {
+    auto entries = _fb_map->entries();
+    auto e = entries ? entries->LookupByKey(key.c_str()) : nullptr;
+    if (!e) {
         throw std::runtime_error("Map key not found");
     }
+    if (!e->value()) {
+        throw std::runtime_error("Map entry without a value");
+    }
+    return e->value();
+}
 
-    auto val = ptr->value();
-
-    return pmt_base::from_pmt(val);
+template <>
+bool pmt_map<std::string>::fb_contains(const std::string& key) const
+{
+    auto entries = _fb_map->entries();
+    return entries && entries->LookupByKey(key.c_str());
 }
 
 template <>
-void pmt_map<std::string>::set(const std::string& k, pmt_sptr v)
+pmt_map<std::string>::pmt_map(const std::map<std::string,pmt_sptr>& val)
+    : pmt_base(Data::MapString), _map(val)
 {
-    auto entire_map = value();
+}
 
-    // checking has key and such ... TODO
+template <>
+pmt_map<std::string>::pmt_map(const pmtf::Pmt* fb_pmt)
+    : pmt_base(Data::MapString), _fb_map(fb_pmt->data_as_MapString())
+{
+    // Without an owner the flatbuffer may go away with the caller
+    decode();
+    _fb_map = nullptr;
+}
 
-    entire_map[k] = v;
+template <>
+pmt_map<std::string>::pmt_map(const pmtf::Pmt* fb_pmt, std::shared_ptr<const void> owner)
+    : pmt_base(Data::MapString), _fb_map(fb_pmt->data_as_MapString()), _owner(owner)
+{
+    if (!_fb_map) {
+        throw std::runtime_error("PMT is not a MapString");
+    }
+}
 
-    set_value(entire_map);
+template <>
+pmt_map<std::string>::pmt_map(const uint8_t* buf, size_t size)
+    : pmt_base(Data::MapString)
+{
+    auto owner = std::make_shared<std::vector<uint8_t>>(buf, buf + size);
+    pmt_view view(owner->data(), owner->size(), owner);
+    if (view.data_type() != Data::MapString) {
+        throw std::runtime_error("PMT is not a MapString");
+    }
+    _fb_map = view.fb()->data_as_MapString();
+    _owner = owner;
 }
 
 
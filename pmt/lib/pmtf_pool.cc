@@ -0,0 +1,100 @@
+#include <pmt/pmtf_pool.hh>
+#include <new>
+
+namespace pmtf {
+
+namespace {
+
+constexpr size_t num_classes = pmt_pool::max_block_size / pmt_pool::granularity;
+
+struct free_block {
+    free_block* next;
+};
+
+struct thread_cache {
+    free_block* heads[num_classes] = {};
+    size_t counts[num_classes] = {};
+
+    thread_cache();
+    ~thread_cache();
+};
+
+enum cache_state : int { CACHE_NONE, CACHE_ALIVE, CACHE_DESTROYED };
+
+// Trivially destructible, so still readable while other thread_local objects are being
+// destroyed and release their pmts after the cache is gone
+thread_local int t_cache_state = CACHE_NONE;
+
+thread_cache::thread_cache() { t_cache_state = CACHE_ALIVE; }
+
+thread_cache::~thread_cache()
+{
+    t_cache_state = CACHE_DESTROYED;
+    for (size_t c = 0; c < num_classes; c++) {
+        while (heads[c]) {
+            auto b = heads[c];
+            heads[c] = b->next;
+            ::operator delete(b);
+        }
+    }
+}
+
+thread_cache* get_cache()
+{
+    thread_local thread_cache cache;
+    return &cache;
+}
+
+size_t size_class(size_t size)
+{
+    return (size + pmt_pool::granularity - 1) / pmt_pool::granularity - 1;
+}
+
+} // namespace
+
+void* pmt_pool::allocate(size_t size)
+{
+    if (size == 0 || size > max_block_size) {
+        return ::operator new(size);
+    }
+
+    auto c = size_class(size);
+    if (t_cache_state == CACHE_DESTROYED) {
+        return ::operator new((c + 1) * granularity);
+    }
+    auto cache = get_cache();
+    if (auto b = cache->heads[c]) {
+        cache->heads[c] = b->next;
+        cache->counts[c]--;
+        return b;
+    }
+    // Always allocate the full class size so the block can be reused for any size in
+    // the class
+    return ::operator new((c + 1) * granularity);
+}
+
+void pmt_pool::deallocate(void* p, size_t size)
+{
+    if (size == 0 || size > max_block_size) {
+        ::operator delete(p);
+        return;
+    }
+
+    if (t_cache_state == CACHE_DESTROYED) {
+        ::operator delete(p);
+        return;
+    }
+
+    auto c = size_class(size);
+    auto cache = get_cache();
+    if (cache->counts[c] >= max_cached_per_class) {
+        ::operator delete(p);
+        return;
+    }
+    auto b = static_cast<free_block*>(p);
+    b->next = cache->heads[c];
+    cache->heads[c] = b;
+    cache->counts[c]++;
+}
+
+} // namespace pmtf
@@ -1,45 +1,64 @@
 #include <pmt/pmtf_string.hh>
 #include <map>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
 
 namespace pmtf {
 
 flatbuffers::Offset<void> pmt_string::rebuild_data(flatbuffers::FlatBufferBuilder& fbb)
 {
-    // fbb.Reset();
-    return CreatePmtStringDirect(fbb, value().c_str()).Union();
+    return CreatePmtString(fbb, fbb.CreateString(_value)).Union();
 }
 
 
+pmt_string::sptr pmt_string::intern(const std::string& value)
+{
+    // Leaked on purpose so that symbols held in static objects stay valid through
+    // static destruction
+    static auto s_mutex = new std::mutex;
+    static auto s_table = new std::unordered_map<std::string, sptr>;
+
+    std::scoped_lock guard(*s_mutex);
+    auto it = s_table->find(value);
+    if (it != s_table->end()) {
+        return it->second;
+    }
+
+    // Symbols are shared between threads and never change, so encode them up front
+    auto sym = std::make_shared<pmt_string>(value);
+    sym->encode();
+    sym->_interned = true;
+    s_table->emplace(value, sym);
+    return sym;
+}
+
 void pmt_string::set_value(const std::string& val)
 {
-    _data = CreatePmtStringDirect(_fbb, val.c_str()).Union();
-    build();
+    if (_interned) {
+        throw std::runtime_error("Cannot modify an interned pmt_string");
+    }
+    _value = val;
+    invalidate();
 }
 
 pmt_string::pmt_string(const std::string& val)
-    : pmt_base(Data::PmtString)
+    : pmt_base(Data::PmtString), _value(val)
 {
-    set_value(val);
 }
 
 pmt_string::pmt_string(const uint8_t *buf)
-    : pmt_base(Data::PmtString)
+    : pmt_string(GetPmt(buf))
 {
-    auto data = GetPmt(buf)->data_as_PmtString()->value();
-    set_value(*((const std::string*)data));
 }
 
 pmt_string::pmt_string(const pmtf::Pmt* fb_pmt)
     : pmt_base(Data::PmtString)
 {
     auto data = fb_pmt->data_as_PmtString()->value();
-    set_value(*((const std::string*)data));
-}
-
-std::string pmt_string::value()
-{
-    auto pmt = GetSizePrefixedPmt(_fbb.GetBufferPointer());
-    return std::string(pmt->data_as_PmtString()->value()->str());
+    if (data) {
+        _value = data->str();
+    }
 }
 
 
@@ -1,4 +1,5 @@
 #include <pmt/pmtf_vector.hh>
+#include <pmt/pmtf_view.hh>
 
 namespace pmtf {
 
@@ -19,3 +20,54 @@ IMPLEMENT_PMT_VECTOR_CPLX(std::complex<float>, Complex64)
 // IMPLEMENT_PMT_VECTOR_CPLX(std::complex<double>, Complex128)
 
 } // namespace pmtf
+
+namespace pmtf {
+
+pmt_vector<pmt_sptr>::pmt_vector(const std::vector<pmt_sptr>& val)
+    : pmt_base(Data::VectorPmt)
+{
+    set_value(val);
+}
+
+pmt_vector<pmt_sptr>::pmt_vector(const pmtf::Pmt* fb_pmt) : pmt_base(Data::VectorPmt)
+{
+    auto fb_vec = fb_pmt->data_as_VectorPmt()->value();
+    if (!fb_vec) {
+        return;
+    }
+    _value.reserve(fb_vec->size());
+    for (auto p : *fb_vec) {
+        _value.push_back(pmt_base::from_pmt(p));
+    }
+}
+
+pmt_vector<pmt_sptr>::pmt_vector(const uint8_t* buf, size_t size)
+    : pmt_vector(pmt_view(buf, size).fb())
+{
+}
+
+flatbuffers::Offset<void>
+pmt_vector<pmt_sptr>::rebuild_data(flatbuffers::FlatBufferBuilder& fbb)
+{
+    std::vector<flatbuffers::Offset<Pmt>> offsets;
+    offsets.reserve(_value.size());
+    for (auto& p : _value) {
+        offsets.push_back(p->splice(fbb));
+    }
+
+    auto vec = fbb.CreateVector(offsets);
+    VectorPmtBuilder vb(fbb);
+    vb.add_value(vec);
+    return vb.Finish().Union();
+}
+
+size_t pmt_vector<pmt_sptr>::compute_hash() const
+{
+    size_t h = hash_bytes(nullptr, 0, (size_t)data_type());
+    for (auto& p : _value) {
+        h = hash_bytes(&h, sizeof(h), p->hash());
+    }
+    return h;
+}
+
+} // namespace pmtf
@@ -0,0 +1,197 @@
+#include <pmt/pmtf_view.hh>
+#include <flatbuffers/flatbuffers.h>
+#include <cstring>
+#include <vector>
+
+namespace pmtf {
+
+pmt_view::pmt_view(const uint8_t* buf, size_t size, std::shared_ptr<const void> owner)
+    : _owner(owner)
+{
+    // Bounds check every offset once here, so accessors can trust the buffer
+    flatbuffers::Verifier verifier(buf, size);
+    if (!VerifyPmtBuffer(verifier)) {
+        throw std::runtime_error("Invalid PMT buffer");
+    }
+    _pmt = GetPmt(buf);
+}
+
+pmt_view pmt_view::size_prefixed(const uint8_t* buf,
+                                 size_t size,
+                                 std::shared_ptr<const void> owner)
+{
+    flatbuffers::Verifier verifier(buf, size);
+    if (!VerifySizePrefixedPmtBuffer(verifier)) {
+        throw std::runtime_error("Invalid PMT buffer");
+    }
+    return pmt_view(GetSizePrefixedPmt(buf), owner);
+}
+
+pmt_view pmt_view::deserialize(std::streambuf& sb, size_t max_size)
+{
+    const size_t prefix_size = sizeof(flatbuffers::uoffset_t);
+    uint8_t prefix[prefix_size];
+    if (sb.sgetn((char*)prefix, prefix_size) != (std::streamsize)prefix_size) {
+        throw std::runtime_error("Truncated PMT size prefix");
+    }
+    size_t size = flatbuffers::ReadScalar<flatbuffers::uoffset_t>(prefix);
+    if (size < prefix_size || size > max_size) {
+        throw std::runtime_error("PMT size prefix out of range: " + std::to_string(size));
+    }
+
+    // Keep the prefix in front of the payload so the payload has the alignment it was
+    // built with
+    auto owner = std::make_shared<std::vector<uint8_t>>(prefix_size + size);
+    memcpy(owner->data(), prefix, prefix_size);
+    if (sb.sgetn((char*)owner->data() + prefix_size, size) != (std::streamsize)size) {
+        throw std::runtime_error("Truncated PMT");
+    }
+
+    return size_prefixed(owner->data(), owner->size(), owner);
+}
+
+Data pmt_view::data_type() const
+{
+    if (!_pmt) {
+        throw std::runtime_error("Empty PMT view");
+    }
+    return _pmt->data_type();
+}
+
+std::string_view pmt_view::string() const
+{
+    if (data_type() != Data::PmtString) {
+        throw std::runtime_error("PMT view is not a PmtString");
+    }
+    auto str = _pmt->data_as_PmtString()->value();
+    if (!str) {
+        return std::string_view();
+    }
+    return std::string_view(str->c_str(), str->size());
+}
+
+const MapEntryString* pmt_view::lookup(const std::string& key) const
+{
+    if (data_type() != Data::MapString) {
+        throw std::runtime_error("PMT view is not a MapString");
+    }
+    auto entries = _pmt->data_as_MapString()->entries();
+    if (!entries) {
+        return nullptr;
+    }
+    return entries->LookupByKey(key.c_str());
+}
+
+pmt_view pmt_view::ref(const std::string& key) const
+{
+    auto entry = lookup(key);
+    if (entry == nullptr) {
+        throw std::runtime_error("Map key not found");
+    }
+    return pmt_view(entry->value(), _owner);
+}
+
+bool pmt_view::contains(const std::string& key) const { return lookup(key) != nullptr; }
+
+size_t pmt_view::map_size() const
+{
+    if (data_type() != Data::MapString) {
+        throw std::runtime_error("PMT view is not a MapString");
+    }
+    auto entries = _pmt->data_as_MapString()->entries();
+    return entries ? entries->size() : 0;
+}
+
+const flatbuffers::Vector<flatbuffers::Offset<Pmt>>* pmt_view::list() const
+{
+    if (data_type() != Data::VectorPmt) {
+        throw std::runtime_error("PMT view is not a VectorPmt");
+    }
+    return _pmt->data_as_VectorPmt()->value();
+}
+
+pmt_view pmt_view::list_ref(size_t k) const
+{
+    auto fb_vec = list();
+    if (!fb_vec || k >= fb_vec->size()) {
+        throw std::runtime_error("PMT Vector index out of range");
+    }
+    return pmt_view(fb_vec->Get(k), _owner);
+}
+
+size_t pmt_view::list_size() const
+{
+    auto fb_vec = list();
+    return fb_vec ? fb_vec->size() : 0;
+}
+
+pmt_sptr pmt_view::to_pmt() const
+{
+    if (!_pmt) {
+        throw std::runtime_error("Empty PMT view");
+    }
+    return pmt_base::from_pmt(_pmt, _owner);
+}
+
+#define IMPLEMENT_PMT_VIEW_SCALAR(datatype, fbtype)                          \
+    template <>                                                              \
+    datatype pmt_view::scalar<datatype>() const                              \
+    {                                                                        \
+        if (data_type() != Data::Scalar##fbtype)                             \
+            throw std::runtime_error("PMT view is not a Scalar" #fbtype);    \
+        return _pmt->data_as_Scalar##fbtype()->value();                      \
+    }
+
+#define IMPLEMENT_PMT_VIEW_SCALAR_CPLX(datatype, fbtype)                     \
+    template <>                                                              \
+    datatype pmt_view::scalar<datatype>() const                              \
+    {                                                                        \
+        if (data_type() != Data::Scalar##fbtype)                             \
+            throw std::runtime_error("PMT view is not a Scalar" #fbtype);    \
+        auto val = _pmt->data_as_Scalar##fbtype()->value();                  \
+        return val ? *((const datatype*)val) : datatype();                   \
+    }
+
+#define IMPLEMENT_PMT_VIEW_VECTOR(datatype, fbtype)                                  \
+    template <>                                                                      \
+    pmt_vector_view<datatype> pmt_view::vector<datatype>() const                     \
+    {                                                                                \
+        if (data_type() != Data::Vector##fbtype)                                     \
+            throw std::runtime_error("PMT view is not a Vector" #fbtype);            \
+        auto fb_vec = _pmt->data_as_Vector##fbtype()->value();                       \
+        if (!fb_vec)                                                                 \
+            return pmt_vector_view<datatype>(nullptr, 0, _owner);                    \
+        /* complex structs have the same layout as std::complex, so cast here */     \
+        return pmt_vector_view<datatype>(                                            \
+            (const datatype*)fb_vec->Data(), fb_vec->size(), _owner);                \
+    }
+
+IMPLEMENT_PMT_VIEW_SCALAR(int8_t, Int8)
+IMPLEMENT_PMT_VIEW_SCALAR(uint8_t, UInt8)
+IMPLEMENT_PMT_VIEW_SCALAR(int16_t, Int16)
+IMPLEMENT_PMT_VIEW_SCALAR(uint16_t, UInt16)
+IMPLEMENT_PMT_VIEW_SCALAR(int32_t, Int32)
+IMPLEMENT_PMT_VIEW_SCALAR(uint32_t, UInt32)
+IMPLEMENT_PMT_VIEW_SCALAR(int64_t, Int64)
+IMPLEMENT_PMT_VIEW_SCALAR(uint64_t, UInt64)
+IMPLEMENT_PMT_VIEW_SCALAR(bool, Bool)
+IMPLEMENT_PMT_VIEW_SCALAR(float, Float32)
+IMPLEMENT_PMT_VIEW_SCALAR(double, Float64)
+
+IMPLEMENT_PMT_VIEW_SCALAR_CPLX(std::complex<float>, Complex64)
+IMPLEMENT_PMT_VIEW_SCALAR_CPLX(std::complex<double>, Complex128)
+
+IMPLEMENT_PMT_VIEW_VECTOR(int8_t, Int8)
+IMPLEMENT_PMT_VIEW_VECTOR(uint8_t, UInt8)
+IMPLEMENT_PMT_VIEW_VECTOR(int16_t, Int16)
+IMPLEMENT_PMT_VIEW_VECTOR(uint16_t, UInt16)
+IMPLEMENT_PMT_VIEW_VECTOR(int32_t, Int32)
+IMPLEMENT_PMT_VIEW_VECTOR(uint32_t, UInt32)
+IMPLEMENT_PMT_VIEW_VECTOR(int64_t, Int64)
+IMPLEMENT_PMT_VIEW_VECTOR(uint64_t, UInt64)
+IMPLEMENT_PMT_VIEW_VECTOR(float, Float32)
+IMPLEMENT_PMT_VIEW_VECTOR(double, Float64)
+IMPLEMENT_PMT_VIEW_VECTOR(std::complex<float>, Complex64)
+IMPLEMENT_PMT_VIEW_VECTOR(std::complex<double>, Complex128)
+
+} // namespace pmtf
@@ -1,11 +1,15 @@
 #include <gtest/gtest.h>
 #include <complex>
+#include <thread>
+#include <unordered_map>
 
 #include <pmt/pmtf.hh>
+#include <pmt/pmtf_batch.hh>
 #include <pmt/pmtf_map.hh>
 #include <pmt/pmtf_scalar.hh>
 #include <pmt/pmtf_string.hh>
 #include <pmt/pmtf_vector.hh>
+#include <pmt/pmtf_view.hh>
 
 using namespace pmtf;
 
@@ -35,6 +39,24 @@ TEST(Pmt, PmtStringTests)
     EXPECT_EQ(str_pmt->value(), "hello");
 }
 
+TEST(Pmt, PmtStringIntern)
+{
+    auto a = pmt_string::intern("seq");
+    auto b = pmt_string::intern(std::string("se") + "q");
+    auto c = pmt_string::intern("other");
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_TRUE(a->interned());
+    EXPECT_EQ(a->value(), "seq");
+
+    // A regular string pmt is a distinct, mutable object
+    auto d = pmt_string::make("seq");
+    EXPECT_NE(a, d);
+    EXPECT_FALSE(d->interned());
+    EXPECT_THROW(a->set_value("changed"), std::runtime_error);
+    EXPECT_EQ(b->value(), "seq");
+}
 
 TEST(Pmt, PmtMapTests)
 {
@@ -65,6 +87,278 @@ TEST(Pmt, PmtMapTests)
               val2);
 }
 
+TEST(Pmt, PmtMapLookup)
+{
+    std::map<std::string, pmt_sptr> input_map;
+    for (int i = 0; i < 100; i++) {
+        input_map["key" + std::to_string(i)] = pmt_scalar<int32_t>::make(i);
+    }
+    auto map_pmt = pmt_map<std::string>::make(input_map);
+
+    EXPECT_EQ(map_pmt->size(), input_map.size());
+    EXPECT_TRUE(map_pmt->contains("key42"));
+    EXPECT_FALSE(map_pmt->contains("key100"));
+    EXPECT_EQ(std::static_pointer_cast<pmt_scalar<int32_t>>(map_pmt->at("key42"))->value(),
+              42);
+    EXPECT_THROW(map_pmt->at("key100"), std::runtime_error);
+
+    // Iteration follows the sorted key order of std::map
+    auto it = input_map.begin();
+    for (auto& [key, val] : *map_pmt) {
+        EXPECT_EQ(key, it->first);
+        EXPECT_EQ(std::static_pointer_cast<pmt_scalar<int32_t>>(val)->value(),
+                  std::static_pointer_cast<pmt_scalar<int32_t>>(it->second)->value());
+        ++it;
+    }
+    EXPECT_EQ(it, input_map.end());
+}
+
+TEST(Pmt, PmtMapFromBuffer)
+{
+    std::map<std::string, pmt_sptr> input_map;
+    for (int i = 0; i < 100; i++) {
+        input_map["key" + std::to_string(i)] = pmt_scalar<int32_t>::make(i);
+    }
+    input_map["inner"] =
+        pmt_map<std::string>::make({ { "x", pmt_scalar<int32_t>::make(7) } });
+    auto map_pmt = pmt_map<std::string>::make(input_map);
+
+    std::stringbuf sb;
+    map_pmt->serialize(sb);
+    auto map_copy =
+        std::static_pointer_cast<pmt_map<std::string>>(pmt_base::deserialize(sb));
+
+    // Lookups read the received flatbuffer
+    EXPECT_EQ(map_copy->size(), input_map.size());
+    EXPECT_TRUE(map_copy->contains("key42"));
+    EXPECT_FALSE(map_copy->contains("key100"));
+    EXPECT_EQ(std::static_pointer_cast<pmt_scalar<int32_t>>(map_copy->at("key42"))->value(),
+              42);
+    EXPECT_THROW(map_copy->at("key100"), std::runtime_error);
+    auto inner = std::static_pointer_cast<pmt_map<std::string>>(map_copy->at("inner"));
+    EXPECT_EQ(std::static_pointer_cast<pmt_scalar<int32_t>>(inner->at("x"))->value(), 7);
+    EXPECT_TRUE(*map_copy == *map_pmt);
+    EXPECT_EQ(map_copy->hash(), map_pmt->hash());
+
+    // The first change switches to native entries, keeping the others
+    map_copy->set("key42", pmt_scalar<int32_t>::make(-1));
+    map_copy->set("key100", pmt_scalar<int32_t>::make(100));
+    EXPECT_EQ(map_copy->size(), input_map.size() + 1);
+    EXPECT_EQ(std::static_pointer_cast<pmt_scalar<int32_t>>(map_copy->at("key42"))->value(),
+              -1);
+    EXPECT_EQ(std::static_pointer_cast<pmt_scalar<int32_t>>(map_copy->at("key41"))->value(),
+              41);
+    EXPECT_FALSE(*map_copy == *map_pmt);
+
+    map_copy->serialize(sb);
+    auto map_again =
+        std::static_pointer_cast<pmt_map<std::string>>(pmt_base::deserialize(sb));
+    EXPECT_TRUE(*map_again == *map_copy);
+}
+
+TEST(Pmt, LazyEncoding)
+{
+    // Updates only touch the native value; the encoding is rebuilt when it is read
+    auto scalar = pmt_scalar<int32_t>::make(1);
+    std::stringbuf sb;
+    scalar->serialize(sb);
+    for (int i = 0; i < 1000; i++) {
+        scalar->set_value(i);
+    }
+    scalar->serialize(sb);
+    EXPECT_EQ(std::static_pointer_cast<pmt_scalar<int32_t>>(pmt_base::deserialize(sb))
+                  ->value(),
+              1);
+    EXPECT_EQ(std::static_pointer_cast<pmt_scalar<int32_t>>(pmt_base::deserialize(sb))
+                  ->value(),
+              999);
+
+    auto map_pmt = pmt_map<std::string>::make({});
+    for (int i = 0; i < 1000; i++) {
+        map_pmt->set("key" + std::to_string(i % 10), pmt_scalar<int32_t>::make(i));
+    }
+    map_pmt->serialize(sb);
+    auto map_copy =
+        std::static_pointer_cast<pmt_map<std::string>>(pmt_base::deserialize(sb));
+    EXPECT_EQ(map_copy->size(), (size_t)10);
+    EXPECT_EQ(std::static_pointer_cast<pmt_scalar<int32_t>>(map_copy->at("key3"))->value(),
+              993);
+    EXPECT_TRUE(*map_copy == *map_pmt);
+
+    auto str_pmt = pmt_string::make("before");
+    str_pmt->serialize(sb);
+    *str_pmt = "after";
+    str_pmt->serialize(sb);
+    EXPECT_EQ(std::static_pointer_cast<pmt_string>(pmt_base::deserialize(sb))->value(),
+              "before");
+    EXPECT_EQ(std::static_pointer_cast<pmt_string>(pmt_base::deserialize(sb))->value(),
+              "after");
+}
+
+TEST(Pmt, PooledScalars)
+{
+    // Blocks released on another thread move to that thread's pool and must come back
+    // intact
+    std::vector<pmt_scalar<uint64_t>::sptr> held;
+    for (int round = 0; round < 4; round++) {
+        for (uint64_t i = 0; i < 5000; i++) {
+            held.push_back(pmt_scalar<uint64_t>::make(i));
+        }
+        for (uint64_t i = 0; i < held.size(); i++) {
+            EXPECT_EQ(held[i]->value(), i);
+        }
+        std::thread t([&held] { held.clear(); });
+        t.join();
+    }
+
+    // Scalars only get a builder once they are serialized
+    auto x = pmt_scalar<uint64_t>::make(42);
+    std::stringbuf sb;
+    x->serialize(sb);
+    EXPECT_EQ(std::static_pointer_cast<pmt_scalar<uint64_t>>(pmt_base::deserialize(sb))
+                  ->value(),
+              (uint64_t)42);
+}
+
+TEST(Pmt, BatchSerialization)
+{
+    std::vector<pmt_sptr> pmts;
+    for (int i = 0; i < 100; i++) {
+        if (i % 3 == 0) {
+            pmts.push_back(pmt_vector<double>::make(std::vector<double>(i, i)));
+        } else if (i % 3 == 1) {
+            pmts.push_back(pmt_scalar<uint64_t>::make(i));
+        } else {
+            pmts.push_back(pmt_string::make(std::string(i, 'x')));
+        }
+    }
+
+    std::stringbuf sb;
+    pmt_batch_writer writer;
+    for (auto& p : pmts) {
+        writer.add(p);
+    }
+    EXPECT_EQ(writer.size(), pmts.size());
+    EXPECT_TRUE(writer.write(sb));
+    EXPECT_TRUE(writer.empty());
+    // An empty frame in between
+    EXPECT_TRUE(writer.write(sb));
+
+    pmt_batch_reader reader;
+    ASSERT_TRUE(reader.read(sb));
+    ASSERT_EQ(reader.size(), pmts.size());
+    size_t k = 0;
+    for (auto v : reader) {
+        EXPECT_EQ(v.data_type(), pmts[k]->data_type());
+        if (k % 3 == 0) {
+            auto vec = v.vector<double>();
+            EXPECT_EQ(std::vector<double>(vec.begin(), vec.end()),
+                      std::vector<double>(k, k));
+        } else if (k % 3 == 1) {
+            EXPECT_EQ(v.scalar<uint64_t>(), k);
+        } else {
+            EXPECT_EQ(v.string(), std::string(k, 'x'));
+        }
+        k++;
+    }
+    EXPECT_EQ(k, pmts.size());
+    EXPECT_THROW(reader.view(pmts.size()), std::runtime_error);
+
+    ASSERT_TRUE(reader.read(sb));
+    EXPECT_TRUE(reader.empty());
+    EXPECT_FALSE(reader.read(sb));
+
+    // Truncated frame
+    writer.add(pmts[0]);
+    std::stringbuf full;
+    writer.write(full);
+    std::stringbuf part(full.str().substr(0, full.str().size() - 1));
+    EXPECT_THROW(reader.read(part), std::runtime_error);
+}
+
+TEST(Pmt, HashAndEquality)
+{
+    auto a = pmt_scalar<int32_t>::make(5);
+    auto b = pmt_scalar<int32_t>::make(5);
+    auto c = pmt_scalar<uint32_t>::make(5);
+    EXPECT_TRUE(*a == *b);
+    EXPECT_EQ(a->hash(), b->hash());
+    EXPECT_FALSE(*a == *c); // same bits, different type
+    b->set_value(6);
+    EXPECT_TRUE(*a != *b);
+    EXPECT_NE(a->hash(), b->hash());
+
+    auto v1 = pmt_vector<float>::make({ 1, 2, 3 });
+    auto v2 = pmt_vector<float>::make({ 1, 2, 3 });
+    EXPECT_TRUE(*v1 == *v2);
+    EXPECT_EQ(v1->hash(), v2->hash());
+    v2->set(2, 4);
+    EXPECT_FALSE(*v1 == *v2);
+    EXPECT_NE(v1->hash(), v2->hash());
+
+    auto m1 = pmt_map<std::string>::make({ { "a", a }, { "v", v1 } });
+    auto m2 = pmt_map<std::string>::make(
+        { { "a", pmt_scalar<int32_t>::make(5) }, { "v", pmt_vector<float>::make({ 1, 2, 3 }) } });
+    EXPECT_TRUE(*m1 == *m2);
+    EXPECT_EQ(m1->hash(), m2->hash());
+    m2->set("a", c);
+    EXPECT_FALSE(*m1 == *m2);
+
+    // Keyed on contents, not pointers
+    std::unordered_map<pmt_sptr, int, pmt_hash, pmt_equal> table;
+    table[pmt_string::make("start")] = 1;
+    table[pmt_string::make("stop")] = 2;
+    EXPECT_EQ(table.at(pmt_string::make("stop")), 2);
+    EXPECT_EQ(table.count(pmt_string::make("pause")), (size_t)0);
+    EXPECT_EQ(std::hash<pmt_base>()(*pmt_string::make("start")),
+              pmt_string::make("start")->hash());
+}
+
+TEST(Pmt, PmtList)
+{
+    auto pdu = pmt_vector<double>::make(std::vector<double>(1000, 1.5));
+    auto meta = pmt_map<std::string>::make({ { "len", pmt_scalar<uint32_t>::make(1000) } });
+    std::vector<pmt_sptr> elements{
+        pdu, meta, pmt_string::make("burst"), pmt_scalar<int8_t>::make(-3)
+    };
+
+    auto list = pmt_list::make(elements);
+    EXPECT_EQ(list->data_type(), Data::VectorPmt);
+    EXPECT_EQ(list->size(), elements.size());
+    EXPECT_EQ(list->ref(0), pdu); // shared, not copied
+    EXPECT_THROW(list->ref(4), std::runtime_error);
+    EXPECT_THROW(list->push_back(nullptr), std::runtime_error);
+
+    // Encode once with the scalar unencoded and once with every element spliced
+    for (int pass = 0; pass < 2; pass++) {
+        std::stringbuf sb;
+        list->serialize(sb);
+        auto view = pmt_view::deserialize(sb);
+        EXPECT_EQ(view.list_size(), elements.size());
+        EXPECT_EQ(view.list_ref(0).vector<double>().size(), (size_t)1000);
+        EXPECT_EQ(view.list_ref(1).ref("len").scalar<uint32_t>(), (uint32_t)1000);
+        EXPECT_EQ(view.list_ref(2).string(), "burst");
+        EXPECT_EQ(view.list_ref(3).scalar<int8_t>(), -3);
+
+        auto copy = std::static_pointer_cast<pmt_list>(view.to_pmt());
+        EXPECT_TRUE(*copy == *list);
+        EXPECT_EQ(copy->hash(), list->hash());
+        EXPECT_EQ(copy->size(), list->size());
+
+        elements[3]->serialize(sb); // encodes the scalar
+        list->set(2, pmt_string::make("burst"));
+    }
+
+    // Nested lists
+    auto outer = pmt_list::make({ list, list });
+    std::stringbuf sb;
+    outer->serialize(sb);
+    auto copy = pmt_base::deserialize(sb);
+    EXPECT_TRUE(*copy == *outer);
+    list->push_back(pdu);
+    EXPECT_TRUE(*copy != *pmt_list::make({ list, list }));
+}
+
 TEST(Pmt, VectorWrites)
 {
     {
@@ -99,4 +393,107 @@ TEST(Pmt, VectorWrites)
 
         EXPECT_EQ(int_pmt_vec->value(), int_vec_val_modified);
     }
-}
\ No newline at end of file
+}
+
+TEST(Pmt, FixedVector)
+{
+    auto frame = pmt_vector<float>::make_fixed(64);
+    EXPECT_TRUE(frame->fixed());
+    EXPECT_EQ(frame->value(), std::vector<float>(64, 0));
+
+    auto elements = frame->elements();
+    auto encoded_size = frame->size();
+    auto h = frame->hash();
+    for (int i = 1; i < 4; i++) {
+        std::vector<float> val(64, i);
+        *frame = val;
+        // Same buffer, updated in place
+        EXPECT_EQ(frame->elements(), elements);
+        EXPECT_EQ(frame->value(), val);
+    }
+    EXPECT_NE(frame->hash(), h);
+    EXPECT_EQ(frame->size(), encoded_size);
+    EXPECT_THROW(frame->set_value(std::vector<float>(65)), std::runtime_error);
+
+    std::stringbuf sb;
+    frame->serialize(sb);
+    auto copy = pmt_base::deserialize(sb);
+    EXPECT_TRUE(*copy == *frame);
+
+    // Ordinary vectors still change length
+    auto vec = pmt_vector<std::complex<float>>::make({ { 1, 2 } });
+    EXPECT_FALSE(vec->fixed());
+    vec->set_value({ { 3, 4 } });
+    EXPECT_EQ(vec->ref(0), std::complex<float>(3, 4));
+    vec->set_value({ { 5, 6 }, { 7, 8 } });
+    EXPECT_EQ(vec->size(), (size_t)2);
+}
+TEST(Pmt, PmtViews)
+{
+    std::vector<float> vec_val(16384);
+    for (size_t i = 0; i < vec_val.size(); i++) {
+        vec_val[i] = i;
+    }
+
+    std::map<std::string, pmt_sptr> input_map({
+        { "data", pmt_vector<float>::make(vec_val) },
+        { "seq", pmt_scalar<uint64_t>::make(42) },
+        { "name", pmt_string::make("pdu") },
+    });
+    auto map_pmt = pmt_map<std::string>::make(input_map);
+
+    std::stringbuf sb;
+    map_pmt->serialize(sb);
+    auto view = pmt_view::deserialize(sb);
+
+    EXPECT_EQ(view.data_type(), Data::MapString);
+    EXPECT_EQ(view.map_size(), (size_t)3);
+    EXPECT_TRUE(view.contains("seq"));
+    EXPECT_FALSE(view.contains("missing"));
+    EXPECT_THROW(view.ref("missing"), std::runtime_error);
+
+    EXPECT_EQ(view.ref("seq").scalar<uint64_t>(), (uint64_t)42);
+    EXPECT_THROW(view.ref("seq").scalar<int32_t>(), std::runtime_error);
+    EXPECT_EQ(view.ref("name").string(), "pdu");
+
+    // The elements are read in place, and stay valid after the parent view is gone
+    auto elements = view.ref("data").vector<float>();
+    view = pmt_view();
+    EXPECT_EQ(elements.size(), vec_val.size());
+    EXPECT_EQ(std::vector<float>(elements.begin(), elements.end()), vec_val);
+}
+
+TEST(Pmt, BoundedDeserialize)
+{
+    auto p = pmt_vector<int32_t>::make(std::vector<int32_t>(1024, 7));
+    std::string wire;
+    {
+        std::stringbuf sb;
+        p->serialize(sb);
+        wire = sb.str();
+    }
+
+    {
+        std::stringbuf sb(wire);
+        auto q = pmt_base::deserialize(sb);
+        EXPECT_EQ(std::static_pointer_cast<pmt_vector<int32_t>>(q)->value(),
+                  std::vector<int32_t>(1024, 7));
+    }
+    {
+        // Stream ends before the payload does
+        std::stringbuf sb(wire.substr(0, wire.size() / 2));
+        EXPECT_THROW(pmt_base::deserialize(sb), std::runtime_error);
+    }
+    {
+        // Payload larger than the caller allows
+        std::stringbuf sb(wire);
+        EXPECT_THROW(pmt_base::deserialize(sb, 1024), std::runtime_error);
+    }
+    {
+        // Corrupt the root offset so it points past the end of the buffer
+        auto bad = wire;
+        bad[4] = bad[5] = bad[6] = (char)0xff;
+        std::stringbuf sb(bad);
+        EXPECT_THROW(pmt_base::deserialize(sb), std::runtime_error);
+    }
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <gnuradio/block.hh>
+#include <chrono>
 #include <vector>
 
 namespace gr {
@@ -39,6 +40,23 @@ public:
      */
     std::vector<unsigned int> processor_affinity() { return _affinity_mask; }
 
+    /*!
+     * \brief Busy-poll for new work for up to this long before parking the thread.
+     *
+     * A parked thread pays a futex wake-up and a context switch (tens of microseconds)
+     * when the next samples arrive, a spinning one only the cache line transfer, at
+     * the cost of keeping its core busy while idle.  Zero (the default) parks right
+     * away.
+     *
+     * \param budget time to spin each time the thread runs out of work
+     */
+    void set_spin_budget(std::chrono::microseconds budget) { _spin_budget = budget; }
+
+    /*!
+     * \brief Get the spin budget, zero if the thread parks right away.
+     */
+    std::chrono::microseconds spin_budget() { return _spin_budget; }
+
 
     /**
      * @brief Get the vector of blocks
@@ -59,6 +77,7 @@ private:
     std::string _name;
     bool _affinity_set = false;
     std::vector<unsigned int> _affinity_mask;
+    std::chrono::microseconds _spin_budget{ 0 };
 };
 
 } // namespace gr
\ No newline at end of file
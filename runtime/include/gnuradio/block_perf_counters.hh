@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace gr {
+
+/**
+ * @brief Performance counters of a block, kept by the scheduler while enabled
+ *
+ * Items are counted on the first input and output port.  Buffer fullness is sampled
+ * at every work call, averaged over the ports of the block
+ *
+ */
+struct block_perf_counters {
+    uint64_t work_calls = 0;
+    uint64_t items_in = 0;
+    uint64_t items_out = 0;
+    uint64_t work_ns = 0; // cumulative
+    uint64_t work_ns_min = 0;
+    uint64_t work_ns_max = 0;
+    uint64_t blocked_in = 0;  // times the block was skipped for lack of input
+    uint64_t blocked_out = 0; // times the block was skipped for lack of output space
+    double input_fullness = 0;  // average fraction of the input buffers filled
+    double output_fullness = 0; // average fraction of the output buffers filled
+
+    double items_per_call() const
+    {
+        return work_calls ? (double)(items_out ? items_out : items_in) / work_calls : 0.0;
+    }
+    double ns_per_item() const
+    {
+        auto items = items_out ? items_out : items_in;
+        return items ? (double)work_ns / items : 0.0;
+    }
+};
+
+/**
+ * @brief Performance counters keyed by block alias
+ *
+ */
+typedef std::map<std::string, block_perf_counters> block_profile;
+
+} // namespace gr
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <gnuradio/tag.hh>
+#include <gnuradio/tag_store.hh>
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -122,7 +124,8 @@ protected:
     void set_type(const std::string& type) { _type = type; }
 
     std::mutex _buf_mutex;
-    std::vector<tag_t> _tags;
+    tag_store _tags;
+    std::atomic<bool> _has_tags{ false }; // lets untagged streams skip _buf_mutex
 
     std::vector<buffer_reader*> _readers;
 
@@ -142,7 +145,12 @@ public:
     size_t buf_size() { return _buf_size; }
     size_t write_index() { return _write_index; }
     uint64_t total_written() const { return _total_written; }
-    const std::vector<tag_t>& tags() { return _tags; }
+
+    /**
+     * @brief Whether the buffer currently holds any tags - checked without the mutex
+     *
+     */
+    bool has_tags() const { return _has_tags.load(std::memory_order_acquire); }
     std::mutex* mutex() { return &_buf_mutex; }
 
     // std::shared_ptr<buffer_properties>& buf_properties() { return _buf_properties; }
@@ -188,7 +196,7 @@ public:
      */
     void add_tags(size_t num_items, std::vector<tag_t>& tags);
 
-    const std::vector<tag_t>& tags() const { return _tags; }
+    const tag_store& tags() const { return _tags; }
 
     void add_tag(tag_t tag);
     void add_tag(uint64_t offset,
@@ -255,6 +263,9 @@ protected:
     uint64_t _total_read = 0;
     size_t _read_index = 0;
     std::mutex _rdr_mutex;
+    size_t _tag_cursor = 0; // where the last tag lookup ended in the buffer's tag_store
+
+    friend class buffer;
 
 
 public:
@@ -270,6 +281,7 @@ public:
     void* read_ptr() { return _buffer->read_ptr(_read_index); }
     virtual void post_read(int num_items) = 0;
     uint64_t total_read() const { return _total_read; }
+    size_t buffer_num_items() { return _buffer->num_items(); }
     // std::shared_ptr<buffer_properties>& buf_properties() { return _buf_properties; }
     size_t max_buffer_read() { return _buf_properties ? _buf_properties->max_buffer_read() : 0; }
     size_t min_buffer_read() { return _buf_properties ? _buf_properties->min_buffer_read() : 0; }
@@ -277,6 +289,8 @@ public:
 
     std::mutex* mutex() { return &_rdr_mutex; }
 
+    bool has_tags() const { return _buffer->has_tags(); }
+
     /**
      * @brief Return the number of items available to be read
      *
@@ -311,7 +325,12 @@ public:
      */
     std::vector<tag_t> get_tags(size_t num_items);
 
-    const std::vector<tag_t>& tags() const;
+    /**
+     * @brief Return a copy of all the tags the buffer holds, taken under its mutex
+     *
+     * @return std::vector<tag_t>
+     */
+    std::vector<tag_t> tags() const;
 };
 
 } // namespace gr
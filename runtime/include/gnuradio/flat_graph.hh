@@ -97,6 +97,26 @@ public:
 
     block_vector_t calc_downstream_blocks(block_sptr block, port_sptr port);
 
+    /**
+     * @brief Sort the blocks so that every block comes after all of its upstream blocks
+     *
+     * @param blocks blocks of this graph to sort
+     * @return block_vector_t
+     */
+    block_vector_t topological_sort(block_vector_t& blocks);
+
+    /**
+     * @brief Order the blocks so that every block comes after the blocks feeding its
+     * stream inputs
+     *
+     * Message connections are ignored, and it does not throw: if the stream edges
+     * between the blocks form a cycle, the blocks are returned in the order given
+     *
+     * @param blocks blocks of this graph to order
+     * @return block_vector_t
+     */
+    block_vector_t stream_order(const block_vector_t& blocks);
+
 protected:
     block_vector_t d_blocks;
 
@@ -116,7 +136,6 @@ private:
     void topological_dfs_visit(block_sptr blk, block_vector_t& output);
 
     std::vector<block_vector_t> partition();
-    block_vector_t topological_sort(block_vector_t& blocks);
 };
 
 typedef std::shared_ptr<flat_graph> flat_graph_sptr;
@@ -28,6 +28,8 @@ private:
     scheduler_sptr d_default_scheduler = nullptr;
     bool d_default_scheduler_inuse = true;
 
+    std::string d_trace_path;
+
 public:
     
     typedef std::shared_ptr<flowgraph> sptr;
@@ -43,8 +45,62 @@ public:
     void validate();
     void start();
     void stop();
+
+    /**
+     * @brief Wait for the flowgraph to finish and join its threads
+     *
+     * The flowgraph finishes as soon as end of stream has propagated through every
+     * block with stream ports, i.e. once all the data has been flushed to the sinks
+     *
+     */
     void wait();
     void run();
+
+    /**
+     * @brief Becomes ready when the flowgraph has finished, or was stopped
+     *
+     * For waiting with a timeout, or from another thread.  Call wait() afterwards to join
+     * the threads.  Only valid after start()
+     *
+     * @return std::shared_future<void>
+     */
+    std::shared_future<void> completion();
+
+    /**
+     * @brief Enable or disable the per block performance counters of all schedulers
+     *
+     * @param enable
+     */
+    void set_perf_counters(bool enable);
+
+    /**
+     * @brief Performance counters of the blocks of all schedulers, keyed by block alias
+     *
+     * @return block_profile
+     */
+    block_profile perf_counters();
+
+    /**
+     * @brief Record scheduler activity and write it to a file when the flowgraph stops
+     *
+     * The file is in Chrome Trace Event Format, for chrome://tracing or
+     * ui.perfetto.dev.  Only schedulers built with tracing support record anything.
+     * Call before start()
+     *
+     * @param path file to write, or empty to disable tracing
+     */
+    void set_trace_file(const std::string& path);
+
+    /**
+     * @brief Write the activity recorded so far by all schedulers
+     *
+     * Can be called while the flowgraph runs.  Events that are being overwritten at
+     * that moment are left out, so the trace may start slightly later than the ring
+     * holds
+     *
+     * @param path
+     */
+    void write_trace(const std::string& path);
 };
 
 typedef flowgraph::sptr flowgraph_sptr;
@@ -1,14 +1,18 @@
 #pragma once
 
 
-#include <gnuradio/concurrent_queue.hh>
+#include <gnuradio/block.hh>
+#include <gnuradio/mpsc_queue.hh>
 #include <gnuradio/logging.hh>
+#include <future>
+#include <mutex>
+#include <set>
 #include <thread>
 #include <vector>
 
 namespace gr {
 
-enum class fg_monitor_message_t { UNKNOWN, DONE, FLUSHED, KILL };
+enum class fg_monitor_message_t { UNKNOWN, DONE, KILL };
 
 class scheduler;
 
@@ -39,6 +43,11 @@ private:
  * @brief The flowgraph_monitor is responsible for tracking the start/stop status of
  * execution threads in the flowgraph
  *
+ * The schedulers propagate end of stream along the edges themselves, and send a DONE
+ * message for each block as it finishes.  Once every block with stream ports is done,
+ * all the data has been flushed through the graph and the monitor tells the schedulers
+ * to exit
+ *
  */
 class flowgraph_monitor
 {
@@ -49,11 +58,40 @@ public:
     {
 
     } // TODO: bound the queue size
-    virtual ~flowgraph_monitor() {}
+    virtual ~flowgraph_monitor() { stop(); }
 
     virtual void push_message(fg_monitor_message msg) { msgq.push(msg); }
+
+    /**
+     * @brief Track the blocks that need to finish before the flowgraph is done
+     *
+     * Blocks without stream ports are not tracked, they are stopped with the rest.  A
+     * flowgraph of message blocks only runs until it is stopped
+     *
+     * @param blocks
+     */
+    void add_blocks(const std::vector<block_sptr>& blocks);
+
     void start();
-    void stop() { push_message(fg_monitor_message(fg_monitor_message_t::KILL, 0, 0)); }
+
+    /**
+     * @brief End the monitor thread without waiting for the blocks to finish
+     *
+     */
+    void stop();
+
+    /**
+     * @brief Wait for the blocks to finish and the monitor thread to exit
+     *
+     */
+    void wait();
+
+    /**
+     * @brief Becomes ready once the schedulers have been told to exit, or the monitor was
+     * stopped
+     *
+     */
+    std::shared_future<void> completion() { return d_completion; }
 
     /**
      * @brief Replace the specified scheduler pointer with a group of other scheduler
@@ -74,11 +112,18 @@ public:
                            const std::vector<std::shared_ptr<scheduler>> replacements);
 
 private:
-    bool _monitor_thread_stopped = false;
     std::vector<std::shared_ptr<scheduler>> d_schedulers;
+    std::set<nodeid_t> d_blocks;
+    std::thread d_thread;
+    std::promise<void> d_done;
+    std::shared_future<void> d_completion;
+    std::mutex d_join_mutex;
+
+    void run();
+    void join();
 
 protected:
-    concurrent_queue<fg_monitor_message> msgq;
+    mpsc_queue<fg_monitor_message> msgq;
     virtual bool pop_message(fg_monitor_message& msg) { return msgq.pop(msg); }
     virtual void empty_queue() { msgq.clear(); }
 };
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace gr {
+
+/**
+ * @brief Lock-free Multi-producer Single-consumer Queue class
+ *
+ * Drop-in replacement for concurrent_queue.  A non-intrusive Vyukov MPSC queue: each
+ * push fills a node with a copy of the item and links it in with a single atomic
+ * exchange.  Popped nodes go back to a free list that producers take over as a whole, so
+ * once the queue has been as deep as it gets, pushing no longer allocates.  The consumer
+ * parks on a futex only when the queue is empty, so an uncontended push costs a few
+ * atomics and no system call unless the consumer is actually sleeping.
+ *
+ * push() may be called from any thread; try_pop(), pop() and clear() only from the
+ * single consuming thread.
+ *
+ * @tparam T Data type of items in queue
+ */
+template <typename T>
+class mpsc_queue
+{
+private:
+    struct node {
+        std::atomic<node*> next{ nullptr };
+        T value;
+    };
+
+    static void delete_nodes(node* n)
+    {
+        while (n) {
+            auto next = n->next.load(std::memory_order_relaxed);
+            delete n;
+            n = next;
+        }
+    }
+
+    /**
+     * @brief Free nodes a producer thread has taken over, for its next pushes
+     *
+     * Shared by all queues of the same item type, and deleted when the thread exits
+     */
+    struct node_cache {
+        node* head = nullptr;
+        ~node_cache() { delete_nodes(head); }
+    };
+    inline static thread_local node_cache s_cache;
+
+    alignas(64) std::atomic<node*> _head; // producers append here
+    alignas(64) node* _tail;              // consumer reads from here (dummy node)
+    alignas(64) std::atomic<uint32_t> _parked{ 0 };
+    // Nodes released by the consumer.  Producers only ever take the whole list, so the
+    // consumer's pushes to it cannot run into ABA
+    alignas(64) std::atomic<node*> _free{ nullptr };
+
+    node* get_node(const T& msg)
+    {
+        auto n = s_cache.head;
+        if (!n) {
+            n = _free.exchange(nullptr, std::memory_order_acquire);
+        }
+        if (n) {
+            s_cache.head = n->next.load(std::memory_order_relaxed);
+            n->next.store(nullptr, std::memory_order_relaxed);
+        } else {
+            n = new node();
+        }
+        n->value = msg;
+        return n;
+    }
+
+    void release_node(node* n)
+    {
+        auto head = _free.load(std::memory_order_relaxed);
+        do {
+            n->next.store(head, std::memory_order_relaxed);
+        } while (!_free.compare_exchange_weak(
+            head, n, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+#ifndef __linux__
+    std::mutex _park_mutex;
+    std::condition_variable _park_cond;
+#endif
+
+    void park()
+    {
+#ifdef __linux__
+        syscall(SYS_futex,
+                reinterpret_cast<uint32_t*>(&_parked),
+                FUTEX_WAIT_PRIVATE,
+                1,
+                nullptr,
+                nullptr,
+                0);
+#else
+        std::unique_lock<std::mutex> l(_park_mutex);
+        _park_cond.wait(l, [this] { return _parked.load() == 0; });
+#endif
+    }
+
+    void unpark()
+    {
+#ifdef __linux__
+        syscall(SYS_futex,
+                reinterpret_cast<uint32_t*>(&_parked),
+                FUTEX_WAKE_PRIVATE,
+                1,
+                nullptr,
+                nullptr,
+                0);
+#else
+        std::scoped_lock guard(_park_mutex);
+        _park_cond.notify_one();
+#endif
+    }
+
+public:
+    mpsc_queue()
+    {
+        _tail = new node();
+        _head.store(_tail, std::memory_order_relaxed);
+    }
+    ~mpsc_queue()
+    {
+        clear();
+        delete _tail;
+        delete_nodes(_free.load(std::memory_order_acquire));
+    }
+    mpsc_queue(const mpsc_queue&) = delete;
+    mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+    bool push(const T& msg)
+    {
+        auto n = get_node(msg);
+        auto prev = _head.exchange(n, std::memory_order_acq_rel);
+        prev->next.store(n, std::memory_order_release);
+
+        wake();
+
+        return true;
+    }
+
+    /**
+     * @brief Wake the consumer if it is parked in pop(), without queueing anything
+     *
+     * Used together with the abort predicate of pop() to signal state that lives outside
+     * of the queue
+     */
+    void wake()
+    {
+        // Pairs with the fence in pop(): either the consumer sees the new state before
+        // it parks, or we see that it is parked and wake it
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_parked.load(std::memory_order_relaxed) &&
+            _parked.exchange(0, std::memory_order_acq_rel)) {
+            unpark();
+        }
+    }
+
+    /**
+     * @brief Check from the consumer thread whether anything is waiting to be popped
+     *
+     */
+    bool empty() { return _tail->next.load(std::memory_order_acquire) == nullptr; }
+
+    // Non-blocking
+    bool try_pop(T& msg)
+    {
+        auto tail = _tail;
+        auto next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            // Empty, or a producer is between the exchange and the link - in which case
+            // it will wake us up after linking
+            return false;
+        }
+        msg = std::move(next->value);
+        _tail = next;
+        release_node(tail);
+        return true;
+    }
+
+    bool pop(T& msg)
+    {
+        return pop(msg, [] { return false; });
+    }
+
+    /**
+     * @brief Blocking pop that gives up when the abort predicate becomes true
+     *
+     * The predicate is re-evaluated every time the consumer is about to park and after
+     * every wake(), so producers of external state must update that state before calling
+     * wake()
+     *
+     * @return true if an item was popped, false if aborted
+     */
+    template <typename Predicate>
+    bool pop(T& msg, Predicate abort)
+    {
+        while (!try_pop(msg)) {
+            if (abort()) {
+                return false;
+            }
+            _parked.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (try_pop(msg)) {
+                _parked.store(0, std::memory_order_relaxed);
+                return true;
+            }
+            if (abort()) {
+                _parked.store(0, std::memory_order_relaxed);
+                return false;
+            }
+            park();
+            _parked.store(0, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    void clear()
+    {
+        T msg;
+        while (try_pop(msg)) {
+        }
+    }
+};
+} // namespace gr
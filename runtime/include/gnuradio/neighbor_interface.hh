@@ -9,6 +9,37 @@ struct neighbor_interface
     neighbor_interface() {}
     virtual ~neighbor_interface() {}
     virtual void push_message(scheduler_message_sptr msg) = 0;
+
+    /**
+     * @brief Signal that there may be work to do, without carrying any payload
+     *
+     * Stream notifications from neighboring blocks happen after every work call and
+     * only mean "look again", so implementations can coalesce them rather than queueing
+     * a message for each one.  The default falls back to push_message()
+     *
+     * @param action
+     */
+    virtual void notify(scheduler_action_t action)
+    {
+        push_message(std::make_shared<scheduler_action>(action));
+    }
+
+    /**
+     * @brief Deliver a message port message without a trip through the message queue
+     *
+     * Message ports try this first.  An implementation that is running on the calling
+     * thread can hold on to the message (the callback must stay valid until it is called)
+     * and run it from its own loop.  Returning false, as the default does, makes the port
+     * fall back to push_message()
+     *
+     * @param cb callback of the receiving port
+     * @param msg
+     * @return true if the message was taken
+     */
+    virtual bool push_local_message(const message_port_callback_fcn& cb, pmtf::pmt_sptr msg)
+    {
+        return false;
+    }
 };
 typedef std::shared_ptr<neighbor_interface> neighbor_interface_sptr;
 
@@ -4,6 +4,7 @@
 #include <gnuradio/parameter_types.hh>
 #include <gnuradio/buffer.hh>
 #include <algorithm>
+#include <atomic>
 #include <string>
 #include <typeindex>
 #include <typeinfo>
@@ -109,6 +110,16 @@ public:
     void set_buffer_reader(buffer_reader_sptr rdr) { _buffer_reader = rdr; }
     buffer_reader_sptr buffer_reader() { return _buffer_reader; }
 
+    /**
+     * @brief End of stream: the block owning this port will not read or write it again
+     *
+     * Set by the scheduler once the block is finished, after its last write, so that a
+     * reader that sees the flag (acquire) also sees every item that was produced
+     *
+     */
+    bool finished() { return _finished.load(std::memory_order_acquire); }
+    void set_finished(bool finished) { _finished.store(finished, std::memory_order_release); }
+
     void notify_connected_ports(scheduler_message_sptr msg)
     {
         for (auto& p : _connected_ports) {
@@ -122,6 +133,21 @@ public:
         //  scheduler.  This needs more investigation
         // this->push_message(msg);
     }
+    void notify_connected_ports(scheduler_action_t action)
+    {
+        for (auto& p : _connected_ports) {
+            p->notify(action);
+        }
+    }
+    // Inbound notifications - coalesced by the owning thread
+    void notify(scheduler_action_t action)
+    {
+        if (_parent_intf) {
+            _parent_intf->notify(action);
+        } else {
+            throw std::runtime_error("port has no parent interface");
+        }
+    }
     // Inbound messages
     virtual void push_message(scheduler_message_sptr msg)
     {
@@ -163,6 +189,7 @@ protected:
     neighbor_interface_sptr _parent_intf = nullptr;
     buffer_sptr _buffer = nullptr;
     buffer_reader_sptr _buffer_reader = nullptr;
+    std::atomic<bool> _finished = false;
 };
 
 typedef port_base::sptr port_sptr;
@@ -271,9 +298,28 @@ public:
 
     message_port_callback_fcn callback() { return _callback_fcn; }
     void register_callback(message_port_callback_fcn fcn) { _callback_fcn = fcn; }
-    void post(pmtf::pmt_sptr msg) // should be a pmt, just pass strings for now
+    void post(pmtf::pmt_sptr msg)
+    {
+        for (auto& p : _connected_ports) {
+            // Receivers running on this thread take the message directly; the others
+            // get their own queued copy, since push_message() sets the callback on it
+            if (p->type() == port_type_t::MESSAGE &&
+                std::static_pointer_cast<message_port>(p)->push_local(msg)) {
+                continue;
+            }
+            p->push_message(std::make_shared<msgport_message>(msg, _callback_fcn));
+        }
+    }
+    /**
+     * @brief Hand a message to the owning thread's local queue if this is that thread
+     *
+     * @param msg
+     * @return false if the message has to go through push_message()
+     */
+    bool push_local(pmtf::pmt_sptr msg)
     {
-        notify_connected_ports(std::make_shared<msgport_message>(msg, _callback_fcn));
+        return _parent_intf && _callback_fcn &&
+               _parent_intf->push_local_message(_callback_fcn, msg);
     }
     virtual void push_message(scheduler_message_sptr msg)
     {
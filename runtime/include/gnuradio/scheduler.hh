@@ -5,11 +5,13 @@
 #include <memory>
 #include <mutex>
 
+#include <gnuradio/block_perf_counters.hh>
 #include <gnuradio/buffer.hh>
 #include <gnuradio/flat_graph.hh>
 #include <gnuradio/flowgraph_monitor.hh>
 #include <gnuradio/logging.hh>
 #include <gnuradio/scheduler_message.hh>
+#include <gnuradio/trace_event.hh>
 #include <gnuradio/neighbor_interface_info.hh>
 namespace gr {
 
@@ -45,6 +47,42 @@ public:
         _default_buf_properties = bp;
     }
 
+    /**
+     * @brief Enable or disable the per block performance counters
+     *
+     * Schedulers that don't keep counters ignore this
+     *
+     * @param enable
+     */
+    virtual void set_perf_counters(bool enable) {}
+
+    /**
+     * @brief Snapshot of the per block performance counters, keyed by block alias
+     *
+     * Safe to call while the flowgraph is running
+     *
+     * @return block_profile
+     */
+    virtual block_profile perf_counters() { return {}; }
+
+    /**
+     * @brief Enable or disable recording of scheduler activity for trace_events()
+     *
+     * Schedulers that don't record traces, or were built without tracing, ignore this
+     *
+     * @param enable
+     */
+    virtual void set_tracing(bool enable) {}
+
+    /**
+     * @brief Recorded activity
+     *
+     * Safe to call while the scheduler runs
+     *
+     * @return std::vector<trace_event>
+     */
+    virtual std::vector<trace_event> trace_events() { return {}; }
+
 protected:
     logger_sptr _logger;
     logger_sptr _debug_logger;
@@ -5,7 +5,7 @@
 
 namespace gr {
 
-enum class scheduler_action_t { DONE, NOTIFY_OUTPUT, NOTIFY_INPUT, NOTIFY_ALL, EXIT };
+enum class scheduler_action_t { NOTIFY_OUTPUT, NOTIFY_INPUT, NOTIFY_ALL, EXIT };
 
 enum class scheduler_message_t {
     SCHEDULER_ACTION,
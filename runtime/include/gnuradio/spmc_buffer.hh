@@ -0,0 +1,126 @@
+#pragma once
+
+#include <gnuradio/buffer.hh>
+#include <gnuradio/vmcircbuf.hh>
+
+#include <atomic>
+#include <cstdint>
+
+namespace gr {
+
+/**
+ * @brief Lock-free single-producer/multi-consumer circular buffer
+ *
+ * The items live in a doubly mapped vmcirc_buffer, but the write position and the
+ * position of every reader are published as monotonically increasing item counters,
+ * each on its own cache line.  The writer publishes with a release store in post_write()
+ * and readers observe it with an acquire load (and vice versa for post_read()), so
+ * write_info(), read_info() and the post_* calls never take a mutex and a writer and
+ * its readers running on different cores do not contend on anything but the counters
+ * themselves.
+ *
+ * Only one thread may write, and each reader may only be used from one thread at a
+ * time - which is always the case for buffers between blocks.  Tags are still guarded by
+ * the buffer mutex.
+ *
+ */
+class spmc_buffer : public buffer
+{
+private:
+    buffer_sptr _storage; // doubly mapped memory backing this buffer
+    uint8_t* _buffer;
+
+    alignas(64) std::atomic<uint64_t> _written{ 0 };
+
+public:
+    typedef std::shared_ptr<spmc_buffer> sptr;
+
+    static buffer_sptr make(size_t num_items,
+                            size_t item_size,
+                            std::shared_ptr<buffer_properties> buffer_properties);
+
+    spmc_buffer(size_t num_items,
+                size_t item_size,
+                std::shared_ptr<buffer_properties> buf_properties);
+
+    void* read_ptr(size_t index) { return (void*)&_buffer[index]; }
+    void* write_ptr() { return (void*)&_buffer[_write_index]; }
+
+    /**
+     * @brief Total items written, safe to call from any thread
+     *
+     */
+    uint64_t written() const { return _written.load(std::memory_order_acquire); }
+
+    virtual bool write_info(buffer_info_t& info);
+    virtual size_t space_available();
+    virtual void post_write(int num_items);
+
+    virtual std::shared_ptr<buffer_reader>
+    add_reader(std::shared_ptr<buffer_properties> buf_props);
+};
+
+class spmc_buffer_reader : public buffer_reader
+{
+private:
+    spmc_buffer* _spmc_buffer;
+
+    alignas(64) std::atomic<uint64_t> _read{ 0 };
+
+public:
+    spmc_buffer_reader(std::shared_ptr<spmc_buffer> buffer,
+                       std::shared_ptr<buffer_properties> buf_props,
+                       size_t read_index,
+                       uint64_t total_read);
+
+    /**
+     * @brief Total items read, safe to call from any thread
+     *
+     */
+    uint64_t read() const { return _read.load(std::memory_order_acquire); }
+
+    virtual void post_read(int num_items);
+    virtual uint64_t items_available();
+};
+
+class spmc_buffer_properties : public buffer_properties
+{
+public:
+    spmc_buffer_properties(vmcirc_buffer_type mapping_type_ = vmcirc_buffer_type::AUTO,
+                           vmcirc_page_type page_type_ = vmcirc_page_type::DEFAULT,
+                           bool populate_ = false)
+        : buffer_properties(),
+          _mapping_type(mapping_type_),
+          _page_type(page_type_),
+          _populate(populate_)
+    {
+        _bff = spmc_buffer::make;
+    }
+
+    /**
+     * @brief Flavor of doubly mapped memory used to back the buffer
+     *
+     */
+    vmcirc_buffer_type mapping_type() { return _mapping_type; }
+    vmcirc_page_type page_type() { return _page_type; }
+    bool populate() { return _populate; }
+
+    static std::shared_ptr<buffer_properties>
+    make(vmcirc_buffer_type mapping_type_ = vmcirc_buffer_type::AUTO,
+         vmcirc_page_type page_type_ = vmcirc_page_type::DEFAULT,
+         bool populate_ = false)
+    {
+        return std::static_pointer_cast<buffer_properties>(
+            std::make_shared<spmc_buffer_properties>(
+                mapping_type_, page_type_, populate_));
+    }
+
+private:
+    vmcirc_buffer_type _mapping_type;
+    vmcirc_page_type _page_type;
+    bool _populate;
+};
+
+} // namespace gr
+
+#define SPMC_BUFFER_ARGS spmc_buffer_properties::make(vmcirc_buffer_type::AUTO)
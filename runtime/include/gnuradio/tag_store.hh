@@ -0,0 +1,114 @@
+#pragma once
+
+#include <gnuradio/tag.hh>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+namespace gr {
+
+/**
+ * @brief Tags attached to a buffer, kept sorted by offset
+ *
+ * Tags are almost always added in offset order, so adding is an O(1) push to the back
+ * and pruning everything that all readers have consumed is an O(1) pop per tag from the
+ * front.  Windows are located with a binary search, or in amortized O(1) from a cursor
+ * that a reader carries between calls.
+ *
+ * Cursors are absolute positions: they count every tag ever added, so pruning from the
+ * front does not move them.  A cursor is only a hint - it is corrected if tags were
+ * inserted out of order in the meantime.
+ *
+ * Not thread safe - guarded by the mutex of the owning buffer.
+ */
+class tag_store
+{
+private:
+    std::deque<tag_t> _tags;
+    size_t _pruned = 0; // number of tags popped from the front so far
+
+    static bool offset_less(const tag_t& t, uint64_t offset) { return t.offset < offset; }
+
+public:
+    typedef std::deque<tag_t>::const_iterator const_iterator;
+
+    const_iterator begin() const { return _tags.begin(); }
+    const_iterator end() const { return _tags.end(); }
+    size_t size() const { return _tags.size(); }
+    bool empty() const { return _tags.empty(); }
+
+    void add(const tag_t& tag)
+    {
+        if (_tags.empty() || _tags.back().offset <= tag.offset) {
+            _tags.push_back(tag);
+        } else {
+            // Out of order - keep insertion order among tags with equal offsets
+            auto it = std::upper_bound(
+                _tags.begin(), _tags.end(), tag.offset, [](uint64_t o, const tag_t& t) {
+                    return o < t.offset;
+                });
+            _tags.insert(it, tag);
+        }
+    }
+
+    /**
+     * @brief Iterator to the first tag with an offset not less than the given one
+     *
+     */
+    const_iterator lower_bound(uint64_t offset) const
+    {
+        return std::lower_bound(_tags.begin(), _tags.end(), offset, offset_less);
+    }
+
+    /**
+     * @brief Same as lower_bound, but starting from (and updating) a cursor
+     *
+     * For a cursor that follows monotonically increasing offsets - as a reader does -
+     * this touches only the tags that were skipped since the last call
+     */
+    const_iterator lower_bound(uint64_t offset, size_t& cursor) const
+    {
+        if (cursor < _pruned || cursor > _pruned + _tags.size()) {
+            auto it = lower_bound(offset);
+            cursor = _pruned + (it - _tags.begin());
+            return it;
+        }
+
+        auto it = _tags.begin() + (cursor - _pruned);
+        while (it != _tags.begin() && (it - 1)->offset >= offset) {
+            --it;
+        }
+        while (it != _tags.end() && it->offset < offset) {
+            ++it;
+        }
+        cursor = _pruned + (it - _tags.begin());
+        return it;
+    }
+
+    /**
+     * @brief Copy the tags with offsets in [start, end) to the back of out
+     *
+     */
+    void window(uint64_t start, uint64_t end, std::vector<tag_t>& out, size_t& cursor) const
+    {
+        for (auto it = lower_bound(start, cursor); it != _tags.end() && it->offset < end;
+             ++it) {
+            out.push_back(*it);
+        }
+    }
+
+    /**
+     * @brief Drop all tags with offsets less than the given one
+     *
+     */
+    void prune(uint64_t offset)
+    {
+        while (!_tags.empty() && _tags.front().offset < offset) {
+            _tags.pop_front();
+            _pruned++;
+        }
+    }
+};
+
+} // namespace gr
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace gr {
+
+/**
+ * @brief One entry of a Chrome Trace Event Format trace
+ *
+ * Schedulers that record their activity return these from scheduler::trace_events(), and
+ * the flowgraph writes them as JSON that chrome://tracing and ui.perfetto.dev load
+ *
+ */
+struct trace_event {
+    std::string name;
+    std::string category;
+    char phase;      // 'X' complete, 'i' instant, 'M' metadata
+    uint64_t ts_ns;  // steady_clock
+    uint64_t dur_ns; // for 'X' events
+    int pid;         // scheduler
+    int tid;         // thread
+    std::vector<std::pair<std::string, std::string>> args; // string valued
+};
+
+/**
+ * @brief Write events as a Chrome Trace Event Format JSON object
+ *
+ * @param os
+ * @param events
+ */
+void write_trace_json(std::ostream& os, const std::vector<trace_event>& events);
+
+} // namespace gr
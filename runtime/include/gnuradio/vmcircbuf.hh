@@ -17,6 +17,16 @@ extern std::mutex s_vm_mutex;
 
 enum class vmcirc_buffer_type { AUTO, SYSV_SHM, MMAP_SHM, MMAP_TMPFILE };
 
+/**
+ * @brief Page backing of the MMAP_TMPFILE buffers
+ *
+ * TRANSPARENT_HUGE asks the kernel to back the buffer with transparent huge pages
+ * (effective when /sys/kernel/mm/transparent_hugepage/shmem_enabled is "advise" or
+ * "always").  HUGETLB maps pages from the reserved hugetlbfs pool and falls back to
+ * regular pages if none are available.  Both round the buffer up to the huge page size
+ */
+enum class vmcirc_page_type { DEFAULT, TRANSPARENT_HUGE, HUGETLB };
+
 
 class vmcirc_buffer_reader;
 
@@ -66,21 +76,39 @@ class vmcirc_buffer_properties : public buffer_properties
 {
 public:
     // typedef sptr std::shared_ptr<buffer_properties>;
-    vmcirc_buffer_properties(vmcirc_buffer_type buffer_type_ = vmcirc_buffer_type::AUTO)
-        : buffer_properties(), _buffer_type(buffer_type_)
+    vmcirc_buffer_properties(vmcirc_buffer_type buffer_type_ = vmcirc_buffer_type::AUTO,
+                             vmcirc_page_type page_type_ = vmcirc_page_type::DEFAULT,
+                             bool populate_ = false)
+        : buffer_properties(),
+          _buffer_type(buffer_type_),
+          _page_type(page_type_),
+          _populate(populate_)
 
     {
         _bff = vmcirc_buffer::make;
     }
     vmcirc_buffer_type buffer_type() { return _buffer_type; }
-    static std::shared_ptr<buffer_properties> make(vmcirc_buffer_type buffer_type_)
+    vmcirc_page_type page_type() { return _page_type; }
+    /**
+     * @brief Whether the pages are faulted in when the buffer is created rather than
+     * on first touch while streaming (MMAP_TMPFILE only)
+     *
+     */
+    bool populate() { return _populate; }
+    static std::shared_ptr<buffer_properties>
+    make(vmcirc_buffer_type buffer_type_,
+         vmcirc_page_type page_type_ = vmcirc_page_type::DEFAULT,
+         bool populate_ = false)
     {
         return std::static_pointer_cast<buffer_properties>(
-            std::make_shared<vmcirc_buffer_properties>(buffer_type_));
+            std::make_shared<vmcirc_buffer_properties>(
+                buffer_type_, page_type_, populate_));
     }
 
 private:
     vmcirc_buffer_type _buffer_type;
+    vmcirc_page_type _page_type;
+    bool _populate;
 };
 
 } // namespace gr
@@ -90,3 +118,5 @@ private:
     vmcirc_buffer_properties::make(vmcirc_buffer_type::SYSV_SHM)
 #define VMCIRC_BUFFER_MMAP_SHM_ARGS \
     vmcirc_buffer_properties::make(vmcirc_buffer_type::MMAP_SHM)
+#define VMCIRC_BUFFER_MMAP_TMPFILE_ARGS \
+    vmcirc_buffer_properties::make(vmcirc_buffer_type::MMAP_TMPFILE)
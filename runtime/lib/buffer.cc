@@ -38,11 +38,12 @@ void buffer::add_tags(size_t num_items, std::vector<tag_t>& tags)
 {
     std::scoped_lock guard(_buf_mutex);
 
-    for (auto tag : tags) {
+    for (auto& tag : tags) {
         if (tag.offset < _total_written - num_items || tag.offset >= _total_written) {
 
         } else {
-            _tags.push_back(tag);
+            _tags.add(tag);
+            _has_tags.store(true, std::memory_order_release);
         }
     }
 }
@@ -50,21 +51,22 @@ void buffer::add_tags(size_t num_items, std::vector<tag_t>& tags)
 std::vector<tag_t> buffer_reader::tags_in_window(const uint64_t item_start,
                                                  const uint64_t item_end)
 {
-    std::scoped_lock guard(*(_buffer->mutex()));
-
     std::vector<tag_t> ret;
-    for (auto& t : _buffer->tags()) {
-        if (t.offset >= total_read() + item_start && t.offset < total_read() + item_end) {
-            ret.push_back(t);
-        }
+    if (!_buffer->has_tags()) {
+        return ret;
     }
+
+    std::scoped_lock guard(*(_buffer->mutex()));
+    _buffer->tags().window(
+        total_read() + item_start, total_read() + item_end, ret, _tag_cursor);
     return ret;
 }
 
 void buffer::add_tag(tag_t tag)
 {
     std::scoped_lock guard(_buf_mutex);
-    _tags.push_back(tag);
+    _tags.add(tag);
+    _has_tags.store(true, std::memory_order_release);
 }
 void buffer::add_tag(uint64_t offset,
                      pmtf::pmt_sptr key,
@@ -72,23 +74,35 @@ void buffer::add_tag(uint64_t offset,
                      pmtf::pmt_sptr srcid)
 {
     std::scoped_lock guard(_buf_mutex);
-    _tags.emplace_back(offset, key, value, srcid);
+    _tags.add(tag_t(offset, key, value, srcid));
+    _has_tags.store(true, std::memory_order_release);
 }
 
 void buffer::propagate_tags(std::shared_ptr<buffer_reader> p_in_buf, int n_consumed)
 {
-    std::scoped_lock guard(_buf_mutex);
-    for (auto& t : p_in_buf->tags()) {
-        // Propagate the tags that occurred in the processed window
-        if (t.offset >= total_written() && t.offset < total_written() + n_consumed) {
-            // std::cout << "adding tag" << std::endl;
-            _tags.push_back(t);
-        }
+    auto& in_buf = *(p_in_buf->_buffer);
+    if (!in_buf.has_tags()) {
+        return;
+    }
+    std::scoped_lock guard(_buf_mutex, in_buf._buf_mutex);
+
+    // Propagate the tags that occurred in the processed window
+    auto end = total_written() + n_consumed;
+    for (auto t = in_buf._tags.lower_bound(total_written(), p_in_buf->_tag_cursor);
+         t != in_buf._tags.end() && t->offset < end;
+         ++t) {
+        _tags.add(*t);
+        _has_tags.store(true, std::memory_order_release);
     }
 }
 
 void buffer::prune_tags()
 {
+    // Tags are only added and pruned by the writing thread, so this can't race with a
+    // tag appearing
+    if (!has_tags()) {
+        return;
+    }
     std::scoped_lock guard(_buf_mutex);
 
     // Find the min number of items available across readers
@@ -100,15 +114,9 @@ void buffer::prune_tags()
         }
     }
 
-    auto t = std::begin(_tags);
-    while (t != std::end(_tags)) {
-        // Do some stuff
-        if (t->offset < n_read) {
-            t = _tags.erase(t);
-            // std::cout << "removing tag" << std::endl;
-        } else {
-            ++t;
-        }
+    _tags.prune(n_read);
+    if (_tags.empty()) {
+        _has_tags.store(false, std::memory_order_release);
     }
 }
 
@@ -144,23 +152,24 @@ bool buffer_reader::read_info(buffer_info_t& info)
  */
 std::vector<tag_t> buffer_reader::get_tags(size_t num_items)
 {
-    std::scoped_lock guard(*(_buffer->mutex()));
-
     // Find all the tags from total_read to total_read+offset
     std::vector<tag_t> ret;
-    for (auto& tag : _buffer->tags()) {
-        if (tag.offset >= total_read() && tag.offset < total_read() + num_items) {
-            ret.push_back(tag);
-        }
+    if (!_buffer->has_tags()) {
+        return ret;
     }
 
+    std::scoped_lock guard(*(_buffer->mutex()));
+    _buffer->tags().window(total_read(), total_read() + num_items, ret, _tag_cursor);
+
     return ret;
 }
 
-const std::vector<tag_t>& buffer_reader::tags() const
+std::vector<tag_t> buffer_reader::tags() const
 {
+    // Copied while locked - the store changes as writers add tags and readers prune
     std::scoped_lock guard(*(_buffer->mutex()));
-    return _buffer->tags();
+    auto& store = _buffer->tags();
+    return std::vector<tag_t>(store.begin(), store.end());
 }
 
 
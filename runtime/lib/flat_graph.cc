@@ -1,6 +1,8 @@
 #include <assert.h>
 #include <algorithm>
 #include <iterator>
+#include <map>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
@@ -180,6 +182,52 @@ block_vector_t flat_graph::topological_sort(block_vector_t& blocks)
     return result;
 }
 
+block_vector_t flat_graph::stream_order(const block_vector_t& blocks)
+{
+    std::map<nodeid_t, size_t> index;
+    for (size_t i = 0; i < blocks.size(); i++) {
+        index[blocks[i]->id()] = i;
+    }
+
+    std::vector<size_t> indegree(blocks.size(), 0);
+    std::vector<std::vector<size_t>> downstream(blocks.size());
+    for (auto& e : edges()) {
+        if (e->src().port()->type() != port_type_t::STREAM) {
+            continue;
+        }
+        auto src = index.find(e->src().node()->id());
+        auto dst = index.find(e->dst().node()->id());
+        if (src != index.end() && dst != index.end()) {
+            downstream[src->second].push_back(dst->second);
+            indegree[dst->second]++;
+        }
+    }
+
+    // Kahn's algorithm, taking the blocks that are ready in the order given
+    std::set<size_t> ready;
+    for (size_t i = 0; i < blocks.size(); i++) {
+        if (indegree[i] == 0) {
+            ready.insert(i);
+        }
+    }
+    block_vector_t result;
+    while (!ready.empty()) {
+        auto i = *ready.begin();
+        ready.erase(ready.begin());
+        result.push_back(blocks[i]);
+        for (auto d : downstream[i]) {
+            if (--indegree[d] == 0) {
+                ready.insert(d);
+            }
+        }
+    }
+
+    if (result.size() != blocks.size()) { // stream cycle
+        return blocks;
+    }
+    return result;
+}
+
 block_vector_t flat_graph::sort_sources_first(block_vector_t& blocks)
 {
     block_vector_t sources, nonsources, result;
@@ -2,6 +2,7 @@
 #include <gnuradio/graph_utils.hh>
 
 #include <dlfcn.h>
+#include <fstream>
 
 namespace gr {
 
@@ -114,6 +115,7 @@ void flowgraph::partition(std::vector<domain_conf>& confs)
         d_flat_subgraphs.push_back(flat_graph::make_flat(info.subgraph));
         info.scheduler->initialize(d_flat_subgraphs[d_flat_subgraphs.size() - 1],
                                    d_fgmon);
+        d_fgmon->add_blocks(d_flat_subgraphs.back()->calc_used_blocks());
     }
     _validated = true;
 }
@@ -125,9 +127,14 @@ void flowgraph::validate()
 
     d_flat_graph = flat_graph::make_flat(base());
     check_connections(d_flat_graph);
+    d_fgmon->add_blocks(d_flat_graph->calc_used_blocks());
 
-    for (auto sched : d_schedulers)
+    for (auto sched : d_schedulers) {
+        if (!d_trace_path.empty()) {
+            sched->set_tracing(true);
+        }
         sched->initialize(d_flat_graph, d_fgmon);
+    }
 
     _validated = true;
 }
@@ -156,18 +163,66 @@ void flowgraph::stop()
         s->stop();
     }
     d_fgmon->stop();
+    if (!d_trace_path.empty()) {
+        write_trace(d_trace_path);
+    }
 }
 void flowgraph::wait()
 {
     GR_LOG_TRACE(_debug_logger, "wait()");
+    d_fgmon->wait();
     for (auto s : d_schedulers) {
         s->wait();
     }
+    if (!d_trace_path.empty()) {
+        write_trace(d_trace_path);
+    }
 }
+std::shared_future<void> flowgraph::completion() { return d_fgmon->completion(); }
 void flowgraph::run()
 {
     start();
     wait();
 }
 
+void flowgraph::set_perf_counters(bool enable)
+{
+    for (auto s : d_schedulers) {
+        s->set_perf_counters(enable);
+    }
+}
+
+void flowgraph::set_trace_file(const std::string& path)
+{
+    d_trace_path = path;
+    for (auto s : d_schedulers) {
+        s->set_tracing(!path.empty());
+    }
+}
+
+void flowgraph::write_trace(const std::string& path)
+{
+    std::vector<trace_event> events;
+    for (auto s : d_schedulers) {
+        auto e = s->trace_events();
+        events.insert(events.end(), e.begin(), e.end());
+    }
+
+    std::ofstream ofs(path);
+    if (!ofs) {
+        throw std::runtime_error("Unable to write trace " + path);
+    }
+    write_trace_json(ofs, events);
+}
+
+block_profile flowgraph::perf_counters()
+{
+    block_profile ret;
+    for (auto s : d_schedulers) {
+        auto counters = s->perf_counters();
+        ret.insert(counters.begin(), counters.end());
+    }
+    return ret;
+}
+
 } // namespace gr
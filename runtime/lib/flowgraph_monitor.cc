@@ -3,74 +3,79 @@
 #include <gnuradio/logging.hh>
 
 namespace gr {
+void flowgraph_monitor::add_blocks(const std::vector<block_sptr>& blocks)
+{
+    for (auto& b : blocks) {
+        if (!b->input_stream_ports().empty() || !b->output_stream_ports().empty()) {
+            d_blocks.insert(b->id());
+        }
+    }
+}
+
 void flowgraph_monitor::start()
 {
+    stop();
     empty_queue();
+    d_done = std::promise<void>();
+    d_completion = d_done.get_future().share();
     // Start a monitor thread to keep track of when the schedulers signal info back to
     // the main thread
-    std::thread monitor([this]() {
-        auto _logger = logging::get_logger("flowgraph_monitor", "default");
-        auto _debug_logger = logging::get_logger("flowgraph_monitor_dbg", "debug");
-        while (!_monitor_thread_stopped) {
-            // try to pop messages off the queue
-            fg_monitor_message msg;
-            if (pop_message(msg)) // this blocks
-            {
-                if (msg.type() == fg_monitor_message_t::KILL) {
-                    GR_LOG_DEBUG(_debug_logger, "KILL");
-                    _monitor_thread_stopped = true;
-                    break;
-                } else if (msg.type() == fg_monitor_message_t::DONE) {
-                    GR_LOG_DEBUG(_debug_logger, "DONE");
-                    // One scheduler signaled it is done
-                    // Notify the other schedulers that they need to flush
-                    std::this_thread::sleep_for(std::chrono::milliseconds(100)); // DEBUG
-                    for (auto& s : d_schedulers) {
-                        s->push_message(
-                            std::make_shared<scheduler_action>(scheduler_action_t::DONE, 0));
-                    }
-                    break;
+    d_thread = std::thread(&flowgraph_monitor::run, this);
+}
+
+void flowgraph_monitor::run()
+{
+    auto _debug_logger = logging::get_logger("flowgraph_monitor_dbg", "debug");
+
+    auto remaining = d_blocks;
+    while (true) {
+        fg_monitor_message msg;
+        if (!pop_message(msg)) { // this blocks
+            continue;
+        }
+
+        if (msg.type() == fg_monitor_message_t::KILL) {
+            GR_LOG_DEBUG(_debug_logger, "KILL");
+            break;
+        } else if (msg.type() == fg_monitor_message_t::DONE) {
+            GR_LOG_DEBUG(_debug_logger, "DONE from block {}", msg.blkid());
+            // The schedulers have already flushed everything upstream of a finished
+            // block, so nothing is left to wait for once all of them are done
+            remaining.erase(msg.blkid());
+            if (remaining.empty()) {
+                GR_LOG_DEBUG(_debug_logger, "Telling Schedulers to Exit()");
+                for (auto& s : d_schedulers) {
+                    s->push_message(
+                        std::make_shared<scheduler_action>(scheduler_action_t::EXIT, 0));
                 }
+                break;
             }
         }
+    }
 
-        std::map<int, bool> sched_done;
-        for (auto s : d_schedulers) {
-            sched_done[s->id()] = false;
-        }
-        while (!_monitor_thread_stopped) {
-            // Wait until all the threads are done, then send the EXIT message
-            fg_monitor_message msg;
+    d_done.set_value();
+}
 
-            if (pop_message(msg)) // this blocks
-            {
-                if (msg.type() == fg_monitor_message_t::KILL) {
-                    GR_LOG_DEBUG(_debug_logger, "KILL2");
-                    _monitor_thread_stopped = true;
-                    break;
-                } else if (msg.type() == fg_monitor_message_t::FLUSHED) {
-                    sched_done[msg.schedid()] = true;
-                    GR_LOG_DEBUG(_debug_logger, "FLUSHED");
+void flowgraph_monitor::join()
+{
+    std::lock_guard<std::mutex> lock(d_join_mutex);
+    if (d_thread.joinable()) {
+        d_thread.join();
+    }
+}
 
-                    bool all_done = true;
-                    for (auto s : d_schedulers) {
-                        if (!sched_done[s->id()]) {
-                            all_done = false;
-                        }
-                    }
+void flowgraph_monitor::stop()
+{
+    push_message(fg_monitor_message(fg_monitor_message_t::KILL, 0, 0));
+    join();
+}
 
-                    if (all_done) {
-                        for (auto s : d_schedulers) {
-                            GR_LOG_DEBUG(_debug_logger, "Telling Schedulers to Exit()");
-                            s->push_message(std::make_shared<scheduler_action>(
-                                scheduler_action_t::EXIT, 0));
-                        }
-                    }
-                }
-            }
-        }
-    });
-    monitor.detach();
+void flowgraph_monitor::wait()
+{
+    if (d_completion.valid()) {
+        d_completion.wait();
+    }
+    join();
 }
 
 bool flowgraph_monitor::replace_scheduler(
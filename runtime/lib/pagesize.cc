@@ -15,6 +15,8 @@
 #include "pagesize.hh"
 #include <stdio.h>
 #include <unistd.h>
+#include <fstream>
+#include <string>
 
 namespace gr {
 
@@ -45,4 +47,29 @@ int pagesize()
     return s_pagesize;
 }
 
+size_t hugepagesize()
+{
+    static size_t s_hugepagesize = 0;
+
+    if (s_hugepagesize == 0) {
+        // "Hugepagesize:    2048 kB"
+        std::ifstream meminfo("/proc/meminfo");
+        std::string key;
+        while (meminfo >> key) {
+            if (key == "Hugepagesize:") {
+                size_t kb;
+                if (meminfo >> kb) {
+                    s_hugepagesize = kb * 1024;
+                }
+                break;
+            }
+            meminfo.ignore(256, '\n');
+        }
+        if (s_hugepagesize == 0) {
+            s_hugepagesize = 2 * 1024 * 1024;
+        }
+    }
+    return s_hugepagesize;
+}
+
 } /* namespace gr */
@@ -11,6 +11,8 @@
 #ifndef GR_PAGESIZE_H_
 #define GR_PAGESIZE_H_
 
+#include <cstddef>
+
 namespace gr {
 
 /*!
@@ -18,6 +20,11 @@ namespace gr {
  */
 int pagesize();
 
+/*!
+ * \brief return the default huge page size in bytes
+ */
+size_t hugepagesize();
+
 } /* namespace gr */
 
 #endif /* GR_PAGESIZE_H_ */
@@ -0,0 +1,131 @@
+#include <gnuradio/spmc_buffer.hh>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace gr {
+
+buffer_sptr spmc_buffer::make(size_t num_items,
+                              size_t item_size,
+                              std::shared_ptr<buffer_properties> buffer_properties)
+{
+    auto bp = std::dynamic_pointer_cast<spmc_buffer_properties>(buffer_properties);
+    if (bp == nullptr) {
+        throw std::runtime_error(
+            "Failed to cast buffer properties to spmc_buffer_properties");
+    }
+    return buffer_sptr(new spmc_buffer(num_items, item_size, buffer_properties));
+}
+
+spmc_buffer::spmc_buffer(size_t num_items,
+                         size_t item_size,
+                         std::shared_ptr<buffer_properties> buf_properties)
+    : buffer(num_items, item_size, buf_properties)
+{
+    set_type("spmc_buffer");
+
+    auto bp = std::static_pointer_cast<spmc_buffer_properties>(buf_properties);
+    _storage = vmcirc_buffer::make(
+        num_items,
+        item_size,
+        vmcirc_buffer_properties::make(
+            bp->mapping_type(), bp->page_type(), bp->populate()));
+    _buffer = (uint8_t*)_storage->read_ptr(0);
+
+    // The mapping rounds the size up to a whole number of pages
+    _num_items = _storage->num_items();
+    _buf_size = _storage->buf_size();
+    _write_index = 0;
+}
+
+bool spmc_buffer::write_info(buffer_info_t& info)
+{
+    info.ptr = write_ptr();
+    info.n_items = space_available();
+    info.item_size = _item_size;
+    info.total_items = _total_written;
+
+    return true;
+}
+
+size_t spmc_buffer::space_available()
+{
+    // Only the writer calls this, so its own counter can be read relaxed.  The readers'
+    // counters are acquired so that we never hand out space they are still reading
+    auto written = _written.load(std::memory_order_relaxed);
+    uint64_t n_available = 0;
+    for (auto& r : _readers) {
+        auto n = written - static_cast<spmc_buffer_reader*>(r)->read();
+        if (n > n_available) {
+            n_available = n;
+        }
+    }
+
+    // The counters never wrap, so a full buffer is unambiguous and no slot needs to
+    // be kept empty
+    int space = _num_items - n_available;
+
+    if (space < 0)
+        space = 0;
+    space = std::min(space, (int)(_num_items / 2)); // move to a max_fill parameter
+
+    return space;
+}
+
+void spmc_buffer::post_write(int num_items)
+{
+    unsigned int bytes_written = num_items * _item_size;
+
+    // advance the write pointer
+    _write_index += bytes_written;
+    if (_write_index >= _buf_size) {
+        _write_index -= _buf_size;
+    }
+
+    _total_written += num_items;
+
+    // Publish the items to the readers
+    _written.store(_total_written, std::memory_order_release);
+}
+
+std::shared_ptr<buffer_reader>
+spmc_buffer::add_reader(std::shared_ptr<buffer_properties> buf_props)
+{
+    std::shared_ptr<spmc_buffer_reader> r(
+        new spmc_buffer_reader(std::static_pointer_cast<spmc_buffer>(shared_from_this()),
+                               buf_props,
+                               _write_index,
+                               _total_written));
+    _readers.push_back(r.get());
+    return r;
+}
+
+spmc_buffer_reader::spmc_buffer_reader(std::shared_ptr<spmc_buffer> buffer,
+                                       std::shared_ptr<buffer_properties> buf_props,
+                                       size_t read_index,
+                                       uint64_t total_read)
+    : buffer_reader(buffer, buf_props, read_index), _spmc_buffer(buffer.get())
+{
+    _total_read = total_read;
+    _read.store(total_read, std::memory_order_relaxed);
+}
+
+void spmc_buffer_reader::post_read(int num_items)
+{
+    // advance the read pointer
+    _read_index += num_items * _buffer->item_size();
+    if (_read_index >= _buffer->buf_size()) {
+        _read_index -= _buffer->buf_size();
+    }
+    _total_read += num_items;
+
+    // Hand the space back to the writer
+    _read.store(_total_read, std::memory_order_release);
+}
+
+uint64_t spmc_buffer_reader::items_available()
+{
+    return _spmc_buffer->written() - _total_read;
+}
+
+} // namespace gr
@@ -0,0 +1,69 @@
+#include <gnuradio/trace_event.hh>
+
+#include <iomanip>
+
+namespace gr {
+
+static void write_string(std::ostream& os, const std::string& s)
+{
+    os << '"';
+    for (auto c : s) {
+        if (c == '"' || c == '\\') {
+            os << '\\' << c;
+        } else if ((unsigned char)c < 0x20) {
+            os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c
+               << std::dec << std::setfill(' ');
+        } else {
+            os << c;
+        }
+    }
+    os << '"';
+}
+
+// Trace times are in microseconds, keep the nanoseconds as decimals
+static void write_us(std::ostream& os, uint64_t ns)
+{
+    os << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000
+       << std::setfill(' ');
+}
+
+void write_trace_json(std::ostream& os, const std::vector<trace_event>& events)
+{
+    os << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    bool first = true;
+    for (auto& e : events) {
+        os << (first ? "\n" : ",\n") << "{\"name\": ";
+        first = false;
+        write_string(os, e.name);
+        if (!e.category.empty()) {
+            os << ", \"cat\": ";
+            write_string(os, e.category);
+        }
+        os << ", \"ph\": \"" << e.phase << "\", \"pid\": " << e.pid
+           << ", \"tid\": " << e.tid;
+        if (e.phase != 'M') {
+            os << ", \"ts\": ";
+            write_us(os, e.ts_ns);
+        }
+        if (e.phase == 'X') {
+            os << ", \"dur\": ";
+            write_us(os, e.dur_ns);
+        } else if (e.phase == 'i') {
+            os << ", \"s\": \"t\"";
+        }
+        if (!e.args.empty()) {
+            os << ", \"args\": {";
+            for (size_t i = 0; i < e.args.size(); i++) {
+                os << (i ? ", " : "");
+                write_string(os, e.args[i].first);
+                os << ": ";
+                write_string(os, e.args[i].second);
+            }
+            os << "}";
+        }
+        os << "}";
+    }
+    os << "\n]}\n";
+}
+
+} // namespace gr
@@ -1,6 +1,7 @@
 #include <gnuradio/vmcircbuf.hh>
 
 #include "vmcircbuf_mmap_shm_open.hh"
+#include "vmcircbuf_mmap_tmpfile.hh"
 #include "vmcircbuf_sysv_shm.hh"
 #include <cstring>
 #include <mutex>
@@ -23,6 +24,8 @@ buffer_sptr vmcirc_buffer::make(size_t num_items,
             return buffer_sptr(new vmcircbuf_sysv_shm(num_items, item_size, buffer_properties));
         case vmcirc_buffer_type::MMAP_SHM:
             return buffer_sptr(new vmcircbuf_mmap_shm_open(num_items, item_size, buffer_properties));
+        case vmcirc_buffer_type::MMAP_TMPFILE:
+            return buffer_sptr(new vmcircbuf_mmap_tmpfile(num_items, item_size, buffer_properties));
         default:
             throw std::runtime_error("Invalid vmcircbuf buffer_type");
         }
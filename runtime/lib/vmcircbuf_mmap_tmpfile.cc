@@ -0,0 +1,197 @@
+#include "vmcircbuf_mmap_tmpfile.hh"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#ifdef HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+#include "pagesize.hh"
+#include <gnuradio/logging.hh>
+#include <gnuradio/sys_paths.hh>
+
+namespace gr {
+
+namespace {
+
+vmcirc_page_type page_type(std::shared_ptr<buffer_properties> buf_properties)
+{
+    auto bp = std::dynamic_pointer_cast<vmcirc_buffer_properties>(buf_properties);
+    return bp ? bp->page_type() : vmcirc_page_type::DEFAULT;
+}
+
+bool populate(std::shared_ptr<buffer_properties> buf_properties)
+{
+    auto bp = std::dynamic_pointer_cast<vmcirc_buffer_properties>(buf_properties);
+    return bp ? bp->populate() : false;
+}
+
+#if defined(HAVE_MMAP)
+/**
+ * @brief Open an anonymous file of the given size, or return -1
+ *
+ */
+int open_backing_file(size_t size, bool hugetlb)
+{
+    int fd = -1;
+#if defined(HAVE_MEMFD_CREATE)
+    unsigned int flags = MFD_CLOEXEC;
+#if defined(MFD_HUGETLB)
+    if (hugetlb) {
+        flags |= MFD_HUGETLB;
+    }
+#else
+    if (hugetlb) {
+        return -1;
+    }
+#endif
+    fd = memfd_create("gnuradio-vmcircbuf", flags);
+#else
+    if (hugetlb) {
+        return -1;
+    }
+    // Unnamed temporary file: create it and unlink it right away, the mapping keeps it
+    // alive
+    std::string path = std::string(gr::tmp_path()) + "/gnuradio-XXXXXX";
+    fd = mkstemp(&path[0]);
+    if (fd != -1) {
+        unlink(path.c_str());
+    }
+#endif
+    if (fd == -1) {
+        return -1;
+    }
+    if (ftruncate(fd, (off_t)size) == -1) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Map the file twice, back to back, returning the base address or MAP_FAILED
+ *
+ * The address range is reserved with a single anonymous mapping and both copies are
+ * then placed over it with MAP_FIXED, so unlike the shm variants there is no window in
+ * which another thread's mapping can land in the hole - no global lock is needed
+ */
+void* map_twice(int fd, size_t size, int extra_flags)
+{
+    void* base =
+        mmap(nullptr, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        return MAP_FAILED;
+    }
+
+    int flags = MAP_SHARED | MAP_FIXED | extra_flags;
+    if (mmap(base, size, PROT_READ | PROT_WRITE, flags, fd, 0) == MAP_FAILED ||
+        mmap((uint8_t*)base + size, size, PROT_READ | PROT_WRITE, flags, fd, 0) ==
+            MAP_FAILED) {
+        munmap(base, 2 * size);
+        return MAP_FAILED;
+    }
+
+    return base;
+}
+#endif
+
+} // namespace
+
+size_t vmcircbuf_mmap_tmpfile::granularity(std::shared_ptr<buffer_properties> buf_properties)
+{
+    if (page_type(buf_properties) == vmcirc_page_type::DEFAULT) {
+        return gr::pagesize();
+    }
+    return gr::hugepagesize();
+}
+
+vmcircbuf_mmap_tmpfile::vmcircbuf_mmap_tmpfile(
+    size_t num_items, size_t item_size, std::shared_ptr<buffer_properties> buf_properties)
+    : vmcirc_buffer(num_items, item_size, granularity(buf_properties), buf_properties)
+{
+    set_type("vmcircbuf_mmap_tmpfile");
+
+    auto logger = logging::get_logger("vmcircbuf_mmap_tmpfile", "default");
+
+#if !defined(HAVE_MMAP)
+    gr_log_error(logger, "mmap is not available");
+    throw std::runtime_error("gr::vmcircbuf_mmap_tmpfile");
+#else
+    auto pages = page_type(buf_properties);
+
+    if (_buf_size <= 0 || (_buf_size % gr::pagesize()) != 0) {
+        gr_log_error(logger, "invalid _buf_size = {}", _buf_size);
+        throw std::runtime_error("gr::vmcircbuf_mmap_tmpfile");
+    }
+
+    int extra_flags = 0;
+#if defined(MAP_POPULATE)
+    // With transparent huge pages the range has to be advised before it is faulted in,
+    // so that case is populated by hand below
+    if (populate(buf_properties) && pages != vmcirc_page_type::TRANSPARENT_HUGE) {
+        extra_flags |= MAP_POPULATE;
+    }
+#endif
+
+    void* base = MAP_FAILED;
+    if (pages == vmcirc_page_type::HUGETLB) {
+        int fd = open_backing_file(_buf_size, true);
+        if (fd != -1) {
+            base = map_twice(fd, _buf_size, extra_flags);
+            close(fd);
+        }
+        if (base == MAP_FAILED) {
+            gr_log_warn(logger,
+                        "could not map {} bytes of hugetlb pages, falling back to "
+                        "regular pages",
+                        _buf_size);
+        }
+    }
+
+    if (base == MAP_FAILED) {
+        int fd = open_backing_file(_buf_size, false);
+        if (fd == -1) {
+            gr_log_error(logger, "creating backing file failed: {}", strerror(errno));
+            throw std::runtime_error("gr::vmcircbuf_mmap_tmpfile");
+        }
+        base = map_twice(fd, _buf_size, extra_flags);
+        close(fd); // fd no longer needed.  The mapping is retained.
+        if (base == MAP_FAILED) {
+            gr_log_error(logger, "mmap failed: {}", strerror(errno));
+            throw std::runtime_error("gr::vmcircbuf_mmap_tmpfile");
+        }
+    }
+
+    if (pages == vmcirc_page_type::TRANSPARENT_HUGE) {
+#if defined(MADV_HUGEPAGE)
+        if (madvise(base, 2 * _buf_size, MADV_HUGEPAGE) == -1) {
+            gr_log_warn(logger, "madvise(MADV_HUGEPAGE) failed: {}", strerror(errno));
+        }
+#endif
+        if (populate(buf_properties)) {
+            // Both copies share the pages, so touching the first one faults them all
+            // in; the second copy only needs its page tables filled on first access
+            memset(base, 0, _buf_size);
+        }
+    }
+
+    // Now remember the important stuff
+    _buffer = (uint8_t*)base;
+#endif
+}
+
+vmcircbuf_mmap_tmpfile::~vmcircbuf_mmap_tmpfile()
+{
+#if defined(HAVE_MMAP)
+    munmap(_buffer, 2 * _buf_size);
+#endif
+}
+
+} // namespace gr
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <gnuradio/vmcircbuf.hh>
+
+namespace gr {
+class vmcircbuf_mmap_tmpfile : public vmcirc_buffer
+{
+public:
+    typedef std::shared_ptr<vmcirc_buffer> sptr;
+    vmcircbuf_mmap_tmpfile(size_t num_items,
+                           size_t item_size,
+                           std::shared_ptr<buffer_properties> buf_properties);
+    ~vmcircbuf_mmap_tmpfile();
+
+    /**
+     * @brief Size that the buffer has to be a multiple of for the given properties
+     *
+     */
+    static size_t granularity(std::shared_ptr<buffer_properties> buf_properties);
+};
+
+} // namespace gr
@@ -20,6 +20,20 @@ namespace py = pybind11;
 
 void bind_flowgraph(py::module& m)
 {
+    py::class_<gr::block_perf_counters>(m, "block_perf_counters")
+        .def_readonly("work_calls", &gr::block_perf_counters::work_calls)
+        .def_readonly("items_in", &gr::block_perf_counters::items_in)
+        .def_readonly("items_out", &gr::block_perf_counters::items_out)
+        .def_readonly("work_ns", &gr::block_perf_counters::work_ns)
+        .def_readonly("work_ns_min", &gr::block_perf_counters::work_ns_min)
+        .def_readonly("work_ns_max", &gr::block_perf_counters::work_ns_max)
+        .def_readonly("blocked_in", &gr::block_perf_counters::blocked_in)
+        .def_readonly("blocked_out", &gr::block_perf_counters::blocked_out)
+        .def_readonly("input_fullness", &gr::block_perf_counters::input_fullness)
+        .def_readonly("output_fullness", &gr::block_perf_counters::output_fullness)
+        .def("items_per_call", &gr::block_perf_counters::items_per_call)
+        .def("ns_per_item", &gr::block_perf_counters::ns_per_item);
+
     py::class_<gr::flowgraph, gr::graph, gr::node, std::shared_ptr<gr::flowgraph>>(m, "flowgraph")
 
         .def(py::init(&gr::flowgraph::make))
@@ -32,5 +46,9 @@ void bind_flowgraph(py::module& m)
         .def("start", &gr::flowgraph::start)
         .def("stop", &gr::flowgraph::stop)
         .def("wait", &gr::flowgraph::wait)
-        .def("run", &gr::flowgraph::run);
+        .def("run", &gr::flowgraph::run)
+        .def("set_perf_counters", &gr::flowgraph::set_perf_counters, py::arg("enable"))
+        .def("perf_counters", &gr::flowgraph::perf_counters)
+        .def("set_trace_file", &gr::flowgraph::set_trace_file, py::arg("path"))
+        .def("write_trace", &gr::flowgraph::write_trace, py::arg("path"));
 }
@@ -10,6 +10,7 @@
 #include <gnuradio/realtime.hh>
 #include <gnuradio/schedulers/mt/scheduler_mt.hh>
 #include <gnuradio/simplebuffer.hh>
+#include <gnuradio/spmc_buffer.hh>
 #include <gnuradio/vmcircbuf.hh>
 
 #include <iostream>
@@ -43,7 +44,7 @@ int main(int argc, char* argv[])
         "Number of threads (0: tpb")(
         "buffer",
         po::value<int>(&buffer_type)->default_value(1),
-        "Buffer Type (0:simple, 1:vmcirc, 2:cuda, 3:cuda_pinned")(
+        "Buffer Type (0:simple, 1:vmcirc, 2:cuda, 3:cuda_pinned, 4:vmcirc sysv, 5:vmcirc mmap, 6:spmc)")(
         "buffer_size",
         po::value<int>(&buffer_size)->default_value(32768),
         "Buffer Size in bytes")(
@@ -72,6 +73,20 @@ int main(int argc, char* argv[])
         std::cout << "Error: failed to enable real-time scheduling." << std::endl;
     }
 
+    // Properties for the non-simple buffer types
+    auto buffer_args = [buffer_type]() {
+        switch (buffer_type) {
+        case 4:
+            return VMCIRC_BUFFER_SYSV_SHM_ARGS;
+        case 5:
+            return VMCIRC_BUFFER_MMAP_SHM_ARGS;
+        case 6:
+            return SPMC_BUFFER_ARGS;
+        default:
+            return VMCIRC_BUFFER_ARGS;
+        }
+    };
+
     {
         auto src = blocks::null_source::make({sizeof(gr_complex) * veclen});
         auto head = blocks::head::make_cpu({sizeof(gr_complex) * veclen, samples / veclen});
@@ -91,20 +106,20 @@ int main(int argc, char* argv[])
             fg->connect(copy_blks[nblocks - 1], 0, snk, 0);
 
         } else {
-            fg->connect(src, 0, head, 0)->set_custom_buffer(VMCIRC_BUFFER_ARGS);
-            fg->connect(head, 0, copy_blks[0], 0)->set_custom_buffer(VMCIRC_BUFFER_ARGS);
+            fg->connect(src, 0, head, 0)->set_custom_buffer(buffer_args());
+            fg->connect(head, 0, copy_blks[0], 0)->set_custom_buffer(buffer_args());
             for (unsigned int i = 0; i < nblocks - 1; i++) {
-                fg->connect(copy_blks[i], 0, copy_blks[i + 1], 0)->set_custom_buffer(VMCIRC_BUFFER_ARGS);
+                fg->connect(copy_blks[i], 0, copy_blks[i + 1], 0)->set_custom_buffer(buffer_args());
             }
-            fg->connect(copy_blks[nblocks - 1], 0, snk, 0)->set_custom_buffer(VMCIRC_BUFFER_ARGS);
+            fg->connect(copy_blks[nblocks - 1], 0, snk, 0)->set_custom_buffer(buffer_args());
         }
 
         std::cout << "Initializing MT scheduler with buffer size of " << buffer_size << std::endl;
         auto sched = schedulers::scheduler_mt::make("mt", buffer_size);
         fg->add_scheduler(sched);
 
-        if (buffer_type == 1) {
-            sched->set_default_buffer_factory(VMCIRC_BUFFER_ARGS);
+        if (buffer_type != 0) {
+            sched->set_default_buffer_factory(buffer_args());
         }
 
         if (nthreads > 0) {
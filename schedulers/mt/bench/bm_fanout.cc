@@ -10,6 +10,7 @@
 #include <gnuradio/realtime.hh>
 #include <gnuradio/schedulers/mt/scheduler_mt.hh>
 #include <gnuradio/simplebuffer.hh>
+#include <gnuradio/spmc_buffer.hh>
 #include <gnuradio/vmcircbuf.hh>
 
 #include <iostream>
@@ -32,7 +33,7 @@ int main(int argc, char* argv[])
         ("samples", po::value<uint64_t>(&samples)->default_value(15000000),"Number of samples")
         ("veclen", po::value<int>(&veclen)->default_value(1), "Vector Length")
         ("nblocks", po::value<int>(&nblocks)->default_value(1), "Number of copy blocks")
-        ("buffer", po::value<int>(&buffer_type)->default_value(0), "Buffer Type (0:simple, 1:vmcirc, 2:cuda, 3:cuda_pinned")
+        ("buffer", po::value<int>(&buffer_type)->default_value(0), "Buffer Type (0:simple, 1:vmcirc, 2:cuda, 3:cuda_pinned, 4:vmcirc sysv, 5:vmcirc mmap, 6:spmc)")
         ("rt_prio", "Enable Real-time priority");
 
     po::variables_map vm;
@@ -53,6 +54,20 @@ int main(int argc, char* argv[])
         std::cout << "Error: failed to enable real-time scheduling." << std::endl;
     }
 
+    // Properties for the non-simple buffer types
+    auto buffer_args = [buffer_type]() {
+        switch (buffer_type) {
+        case 4:
+            return VMCIRC_BUFFER_SYSV_SHM_ARGS;
+        case 5:
+            return VMCIRC_BUFFER_MMAP_SHM_ARGS;
+        case 6:
+            return SPMC_BUFFER_ARGS;
+        default:
+            return VMCIRC_BUFFER_ARGS;
+        }
+    };
+
     {
         auto src = blocks::null_source::make({sizeof(gr_complex) * veclen});
         auto head = blocks::head::make_cpu({sizeof(gr_complex) * veclen, samples / veclen});
@@ -74,11 +89,11 @@ int main(int argc, char* argv[])
             }
 
         } else {
-            fg->connect(src, 0, head, 0)->set_custom_buffer(VMCIRC_BUFFER_ARGS);
+            fg->connect(src, 0, head, 0)->set_custom_buffer(buffer_args());
 
             for (int i = 0; i < nblocks; i++) {
-                fg->connect(head, 0, copy_blks[i], 0)->set_custom_buffer(VMCIRC_BUFFER_ARGS);
-                fg->connect(copy_blks[i], 0, sink_blks[i], 0)->set_custom_buffer(VMCIRC_BUFFER_ARGS);
+                fg->connect(head, 0, copy_blks[i], 0)->set_custom_buffer(buffer_args());
+                fg->connect(copy_blks[i], 0, sink_blks[i], 0)->set_custom_buffer(buffer_args());
             }
         }
 
@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <gnuradio/blocks/copy.hh>
+#include <gnuradio/flowgraph.hh>
+#include <gnuradio/realtime.hh>
+#include <gnuradio/schedulers/mt/scheduler_mt.hh>
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+using namespace gr;
+
+static int64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * @brief Produces one timestamp each time it is triggered from outside the flowgraph
+ *
+ * The timestamp is taken in trigger(), so the latency includes waking up this thread
+ *
+ */
+class pulse_source : public block
+{
+private:
+    std::atomic<int64_t> d_stamp{ -1 };
+    std::atomic<bool> d_finished{ false };
+
+public:
+    typedef std::shared_ptr<pulse_source> sptr;
+    pulse_source() : block("pulse_source")
+    {
+        add_port(untyped_port::make("out", port_direction_t::OUTPUT, sizeof(int64_t)));
+    }
+
+    void trigger()
+    {
+        d_stamp = now_ns();
+        output_ports()[0]->notify(scheduler_action_t::NOTIFY_ALL);
+    }
+    void finish()
+    {
+        d_finished = true;
+        output_ports()[0]->notify(scheduler_action_t::NOTIFY_ALL);
+    }
+
+    work_return_code_t work(std::vector<block_work_input>& work_input,
+                            std::vector<block_work_output>& work_output) override
+    {
+        auto stamp = d_stamp.exchange(-1);
+        if (stamp < 0) {
+            if (d_finished) {
+                work_output[0].produce(0);
+                return work_return_code_t::WORK_DONE;
+            }
+            // Nothing to do until the next trigger, let the thread park (or spin)
+            return work_return_code_t::WORK_INSUFFICIENT_INPUT_ITEMS;
+        }
+        *static_cast<int64_t*>(work_output[0].items()) = stamp;
+        work_output[0].produce(1);
+        return work_return_code_t::WORK_OK;
+    }
+};
+
+/**
+ * @brief Records the time since each incoming timestamp
+ *
+ */
+class latency_sink : public block
+{
+private:
+    std::vector<int64_t> d_latency_ns;
+    std::atomic<size_t> d_count{ 0 };
+
+public:
+    typedef std::shared_ptr<latency_sink> sptr;
+    latency_sink(size_t n) : block("latency_sink")
+    {
+        add_port(untyped_port::make("in", port_direction_t::INPUT, sizeof(int64_t)));
+        d_latency_ns.reserve(n);
+    }
+
+    work_return_code_t work(std::vector<block_work_input>& work_input,
+                            std::vector<block_work_output>& work_output) override
+    {
+        auto t = now_ns();
+        auto in = static_cast<const int64_t*>(work_input[0].items());
+        for (int i = 0; i < work_input[0].n_items; i++) {
+            d_latency_ns.push_back(t - in[i]);
+        }
+        work_input[0].consume(work_input[0].n_items);
+        d_count.store(d_latency_ns.size(), std::memory_order_release);
+        return work_return_code_t::WORK_OK;
+    }
+
+    size_t count() { return d_count.load(std::memory_order_acquire); }
+    std::vector<int64_t>& latency_ns() { return d_latency_ns; }
+};
+
+int main(int argc, char* argv[])
+{
+    unsigned int pulses;
+    unsigned int nblocks;
+    unsigned int interval_us;
+    unsigned int spin_us;
+    bool rt_prio = false;
+
+    po::options_description desc("Sample Latency Through a Chain of Copy Blocks");
+    desc.add_options()("help,h", "display help")(
+        "pulses",
+        po::value<unsigned int>(&pulses)->default_value(2000),
+        "Number of samples sent one at a time")(
+        "nblocks", po::value<unsigned int>(&nblocks)->default_value(4), "Number of copy blocks")(
+        "interval_us",
+        po::value<unsigned int>(&interval_us)->default_value(200),
+        "Idle time between samples (us)")(
+        "spin_us",
+        po::value<unsigned int>(&spin_us)->default_value(1000),
+        "Spin budget of each thread in the spinning run (us)")(
+        "rt_prio", "Enable Real-time priority");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    if (vm.count("rt_prio")) {
+        rt_prio = true;
+    }
+
+    if (rt_prio && gr::enable_realtime_scheduling() != RT_OK) {
+        std::cout << "Error: failed to enable real-time scheduling." << std::endl;
+    }
+
+    // One thread per block, so every sample crosses nblocks + 1 threads
+    for (bool spin : { false, true }) {
+        auto src = std::make_shared<pulse_source>();
+        auto snk = std::make_shared<latency_sink>(pulses);
+        std::vector<blocks::copy::sptr> copy_blks(nblocks);
+        for (unsigned int i = 0; i < nblocks; i++) {
+            copy_blks[i] = blocks::copy::make({ sizeof(int64_t) });
+        }
+
+        flowgraph_sptr fg(new flowgraph());
+        std::vector<block_sptr> chain{ src };
+        chain.insert(chain.end(), copy_blks.begin(), copy_blks.end());
+        chain.push_back(snk);
+        for (size_t i = 1; i < chain.size(); i++) {
+            fg->connect(chain[i - 1], 0, chain[i], 0);
+        }
+
+        auto sched = schedulers::scheduler_mt::make("mt");
+        for (auto& b : chain) {
+            block_group_properties bgp({ b });
+            if (spin) {
+                bgp.set_spin_budget(std::chrono::microseconds(spin_us));
+            }
+            sched->add_block_group(bgp);
+        }
+        fg->add_scheduler(sched);
+        fg->validate();
+        fg->start();
+
+        for (unsigned int i = 0; i < pulses; i++) {
+            src->trigger();
+            while (snk->count() <= i) {
+                std::this_thread::yield();
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(interval_us));
+        }
+        src->finish();
+        fg->wait();
+
+        auto lat = snk->latency_ns();
+        if (lat.empty()) {
+            continue;
+        }
+        std::sort(lat.begin(), lat.end());
+        auto pct = [&lat](double p) {
+            return lat[std::min(lat.size() - 1, (size_t)(p * lat.size()))] / 1e3;
+        };
+
+        std::string tag = spin ? "[PROFILE_LATENCY_SPIN]" : "[PROFILE_LATENCY_PARK]";
+        std::cout << (spin ? "spin" : "park") << ": min " << pct(0.0) << " us, median "
+                  << pct(0.5) << " us, p99 " << pct(0.99) << " us, max " << pct(1.0)
+                  << " us" << std::endl;
+        std::cout << tag << pct(0.5) << tag << std::endl;
+    }
+}
@@ -1,7 +1,11 @@
+#include <atomic>
 #include <chrono>
+#include <cstdlib>
 #include <iostream>
+#include <new>
 #include <thread>
 
+#include <gnuradio/blocks/annotator.hh>
 #include <gnuradio/blocks/nop.hh>
 #include <gnuradio/blocks/nop_head.hh>
 #include <gnuradio/blocks/null_sink.hh>
@@ -19,6 +23,21 @@ namespace po = boost::program_options;
 
 using namespace gr;
 
+// Count every heap allocation in the process, so that the cost of the scheduler hot
+// path can be checked: the count over a run should not grow with --samples
+static std::atomic<uint64_t> s_num_allocs{ 0 };
+
+void* operator new(std::size_t size)
+{
+    s_num_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
 int main(int argc, char* argv[])
 {
     uint64_t samples;
@@ -26,6 +45,8 @@ int main(int argc, char* argv[])
     int nthreads;
     int veclen;
     int buffer_type;
+    uint64_t tag_interval;
+    int short_runs;
     bool rt_prio = false;
 
     po::options_description desc("Basic Test Flow Graph");
@@ -41,6 +62,12 @@ int main(int argc, char* argv[])
         "buffer",
         po::value<int>(&buffer_type)->default_value(1),
         "Buffer Type (0:simple, 1:vmcirc, 2:cuda, 3:cuda_pinned")(
+        "tag_interval",
+        po::value<uint64_t>(&tag_interval)->default_value(0),
+        "Insert an annotator tagging every N items after the head (0: no tags)")(
+        "short_runs",
+        po::value<int>(&short_runs)->default_value(0),
+        "Afterwards, time back to back runs of a 1000 sample flowgraph")(
         "rt_prio", "Enable Real-time priority");
 
     po::variables_map vm;
@@ -71,9 +98,22 @@ int main(int argc, char* argv[])
         }
         flowgraph_sptr fg(new flowgraph());
 
+        // Optionally tag the stream, so the cost of the tag path on the nop chain can be
+        // compared against an untagged run
+        block_sptr first = head;
+        if (tag_interval > 0) {
+            auto ann = blocks::annotator::make_cpu({ tag_interval,
+                                                     sizeof(gr_complex) * veclen,
+                                                     1,
+                                                     1,
+                                                     tag_propagation_policy_t::TPP_ALL_TO_ALL });
+            fg->connect(head, 0, ann, 0);
+            first = ann;
+        }
+
         if (buffer_type == 0) {
             fg->connect(src, 0, head, 0);
-            fg->connect(head, 0, blks[0], 0);
+            fg->connect(first, 0, blks[0], 0);
             for (int i = 0; i < nblocks - 1; i++) {
                 fg->connect(blks[i], 0, blks[i + 1], 0);
             }
@@ -81,7 +121,7 @@ int main(int argc, char* argv[])
 
         } else {
             fg->connect(src, 0, head, 0)->set_custom_buffer(VMCIRC_BUFFER_ARGS);
-            fg->connect(head, 0, blks[0], 0)->set_custom_buffer(VMCIRC_BUFFER_ARGS);
+            fg->connect(first, 0, blks[0], 0)->set_custom_buffer(VMCIRC_BUFFER_ARGS);
             for (int i = 0; i < nblocks - 1; i++) {
                 fg->connect(blks[i], 0, blks[i + 1], 0)->set_custom_buffer(VMCIRC_BUFFER_ARGS);
             }
@@ -122,14 +162,41 @@ int main(int argc, char* argv[])
         fg->validate();
 
         auto t1 = std::chrono::steady_clock::now();
+        auto allocs1 = s_num_allocs.load();
 
         fg->start();
         fg->wait();
 
+        auto allocs2 = s_num_allocs.load();
         auto t2 = std::chrono::steady_clock::now();
         auto time =
             std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / 1e9;
 
         std::cout << "[PROFILE_TIME]" << time << "[PROFILE_TIME]" << std::endl;
+        std::cout << "[PROFILE_ALLOCS]" << allocs2 - allocs1 << "[PROFILE_ALLOCS]"
+                  << std::endl;
+    }
+
+    // Tiny flowgraphs spend their time starting up and shutting down rather than moving
+    // samples, so this measures the latency from start() to the return of wait()
+    if (short_runs > 0) {
+        auto t1 = std::chrono::steady_clock::now();
+        for (int r = 0; r < short_runs; r++) {
+            auto src = blocks::nop_source::make({ sizeof(gr_complex) });
+            auto head = blocks::nop_head::make({ sizeof(gr_complex), 1000 });
+            auto snk = blocks::null_sink::make({ sizeof(gr_complex) });
+            flowgraph_sptr fg(new flowgraph());
+            fg->connect(src, 0, head, 0);
+            fg->connect(head, 0, snk, 0);
+            fg->start();
+            fg->wait();
+        }
+        auto t2 = std::chrono::steady_clock::now();
+        auto time_per_run =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / 1e9 /
+            short_runs;
+
+        std::cout << "[PROFILE_SHORT_RUN]" << time_per_run << "[PROFILE_SHORT_RUN]"
+                  << std::endl;
     }
 }
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <gnuradio/block_group_properties.hh>
+#include <gnuradio/flat_graph.hh>
+
+#include "graph_executor.hh"
+
+namespace gr {
+namespace schedulers {
+
+/**
+ * @brief Groups blocks onto threads by measured cost
+ *
+ * The cost of a block is the time it spent in work() while the performance counters
+ * were enabled (see scheduler::set_perf_counters), which accounts for both its per item
+ * cost and its item rate.  Blocks that cost at least a thread's fair share
+ * (total / max_threads) get a thread of their own.  Cheaper blocks are merged along
+ * graph edges, cheapest edges first, as long as a group stays within the fair share -
+ * so neighbors share a thread and as few edges as possible cross threads.  Finally the
+ * lightest groups are merged until there are no more than max_threads.
+ *
+ * Blocks missing from the profile are given the median cost of the others.
+ *
+ * A typical use is a short warm-up run with the performance counters enabled, whose
+ * scheduler::perf_counters() are saved with save_profile() and passed to
+ * scheduler_mt::set_auto_partition() for the real runs.  Profiles and groups are keyed
+ * by block alias, which includes the node id, so they replay onto a flowgraph that a
+ * fresh process builds the same way.
+ */
+class auto_partitioner
+{
+public:
+    /**
+     * @brief Construct a new auto partitioner object
+     *
+     * @param profile block costs
+     * @param max_threads 0 for the number of hardware threads
+     */
+    auto_partitioner(const block_profile& profile = {}, size_t max_threads = 0);
+
+    /**
+     * @brief Partition the given blocks of a graph
+     *
+     * @param fg graph holding the edges between the blocks
+     * @param blocks blocks to partition, in stream order (see flat_graph::stream_order)
+     * - groups are numbered in the order of their first block
+     * @return std::vector<block_group_properties> one group per thread
+     */
+    std::vector<block_group_properties> partition(flat_graph_sptr fg,
+                                                  const std::vector<block_sptr>& blocks);
+
+    /**
+     * @brief Write a profile as one line of counters per block, prefixed by its alias
+     *
+     */
+    static void save_profile(const std::string& path, const block_profile& profile);
+    static block_profile load_profile(const std::string& path);
+
+    /**
+     * @brief Write groups as lines of "name alias alias ..."
+     *
+     */
+    static void save_groups(const std::string& path,
+                            std::vector<block_group_properties>& groups);
+    /**
+     * @brief Read groups written by save_groups, looking the aliases up in blocks
+     *
+     * Throws if an alias is not among the blocks
+     *
+     */
+    static std::vector<block_group_properties>
+    load_groups(const std::string& path, const std::vector<block_sptr>& blocks);
+
+private:
+    block_profile d_profile;
+    size_t d_max_threads;
+};
+
+} // namespace schedulers
+} // namespace gr
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <gnuradio/block.hh>
+#include <gnuradio/block_perf_counters.hh>
 #include <gnuradio/buffer.hh>
 #include <gnuradio/buffer_management.hh>
 #include <gnuradio/executor.hh>
 
-#include <map>
+#include <atomic>
+#include <limits>
+#include <vector>
 
 namespace gr {
 namespace schedulers {
@@ -20,7 +23,47 @@ namespace schedulers {
 class graph_executor : public executor
 {
 private:
+    struct counter_set {
+        // Written by the executing thread only, read from anywhere
+        std::atomic<uint64_t> work_calls = 0;
+        std::atomic<uint64_t> items_in = 0;
+        std::atomic<uint64_t> items_out = 0;
+        std::atomic<uint64_t> work_ns = 0;
+        std::atomic<uint64_t> work_ns_min = std::numeric_limits<uint64_t>::max();
+        std::atomic<uint64_t> work_ns_max = 0;
+        std::atomic<uint64_t> blocked_in = 0;
+        std::atomic<uint64_t> blocked_out = 0;
+        // Sums of the per call fullness, in parts per million
+        std::atomic<uint64_t> input_fullness_ppm = 0;
+        std::atomic<uint64_t> output_fullness_ppm = 0;
+    };
+
+    /**
+     * @brief Everything about a block that stays fixed between iterations
+     *
+     * Built once in initialize() so that run_one_iteration does not have to filter the
+     * port lists, copy reader/buffer shared pointers or allocate the work i/o vectors
+     * on every call - only the item counts are refreshed each time
+     *
+     */
+    struct block_plan {
+        block_sptr blk;
+        counter_set* counters;
+        std::vector<port_sptr> input_ports;
+        std::vector<port_sptr> output_ports;
+        std::vector<size_t> input_capacity;  // buffer sizes in items
+        std::vector<size_t> output_capacity;
+        std::vector<block_work_input> work_input;
+        std::vector<block_work_output> work_output;
+        bool finished = false; // done, not run again
+        bool stream = false;   // has stream ports, message only blocks have no work
+    };
+
     std::vector<block_sptr> d_blocks;
+    std::vector<block_plan> d_plans;
+    std::vector<executor_iteration_status> d_status;
+    std::vector<counter_set> d_counters;
+    std::atomic<bool> d_perf_counters = false;
 
     // Move to buffer management
     const int s_fixed_buf_size;
@@ -29,19 +72,73 @@ private:
 
     buffer_manager::sptr _bufman;
 
+    executor_iteration_status run_block(block_plan& plan);
+    executor_iteration_status end_of_stream(block_plan& plan,
+                                            executor_iteration_status status);
+    void finish(block_plan& plan);
+    void count_blocked(block_plan& plan, executor_iteration_status status);
+    void count_work(block_plan& plan,
+                    uint64_t ns,
+                    uint64_t input_ppm,
+                    uint64_t output_ppm,
+                    work_return_code_t ret);
+
 public:
     graph_executor(const std::string& name) : executor(name), s_fixed_buf_size(32768){};
     ~graph_executor(){};
 
-    void initialize(buffer_manager::sptr bufman, std::vector<block_sptr> blocks)
-    {
-        _bufman = bufman;
-        d_blocks = blocks;
-    }
+    /**
+     * @brief Build the execution plan for the blocks
+     *
+     * Must be called after the buffers have been created and attached to the ports
+     *
+     * @param bufman
+     * @param blocks Blocks to execute, in topological order
+     */
+    void initialize(buffer_manager::sptr bufman, std::vector<block_sptr> blocks);
+
+    /**
+     * @brief Execute every block once
+     *
+     * Performs no heap allocations of its own.  A block is DONE when its work returns
+     * WORK_DONE, or at end of stream - when the blocks upstream of an input are finished
+     * and its buffer is drained, or when every block downstream of it is finished.  A
+     * finished block marks its ports so that its neighbors see the end of stream, and is
+     * not run again
+     *
+     * @return Status of each block, indexed by the position of the block in the vector
+     * given to initialize().  The reference stays valid until the next call
+     */
+    const std::vector<executor_iteration_status>& run_one_iteration();
+
+    /**
+     * @brief Status of each block from the most recent run_one_iteration
+     *
+     */
+    const std::vector<executor_iteration_status>& status() { return d_status; }
+
+    const std::vector<block_sptr>& blocks() { return d_blocks; }
+
+    /**
+     * @brief Keep the per block performance counters
+     *
+     * Costs two clock reads and a few relaxed stores per work call, so it is off by
+     * default.  When off, the only cost is one flag check per block per iteration
+     *
+     * @param enable
+     */
+    void set_perf_counters(bool enable) { d_perf_counters = enable; }
 
-    std::map<nodeid_t, executor_iteration_status>
-    run_one_iteration(std::vector<block_sptr> blocks = std::vector<block_sptr>());
+    /**
+     * @brief Counters of a block accumulated while enabled
+     *
+     * Safe to call while the executor is running
+     *
+     * @param idx position of the block in the vector given to initialize()
+     * @return block_perf_counters
+     */
+    block_perf_counters perf_counters(size_t idx) const;
 };
 
 } // namespace schedulers
-} // namespace gr
\ No newline at end of file
+} // namespace gr
@@ -4,6 +4,7 @@
 #include <gnuradio/scheduler.hh>
 #include <gnuradio/vmcircbuf.hh>
 
+#include "auto_partitioner.hh"
 #include "thread_wrapper.hh"
 namespace gr {
 namespace schedulers {
@@ -14,6 +15,11 @@ private:
     const int s_fixed_buf_size;
     std::map<nodeid_t, neighbor_interface_sptr> _block_thread_map;
     std::vector<block_group_properties> _block_groups;
+    bool _perf_counters = false;
+    bool _tracing = false;
+    bool _auto_partition = false;
+    block_profile _auto_profile;
+    size_t _auto_max_threads = 0;
 
 public:
     typedef std::shared_ptr<scheduler_mt> sptr;
@@ -35,6 +41,34 @@ public:
     void add_block_group(const std::vector<block_sptr>& blocks,
                          const std::string& name = "",
                          const std::vector<unsigned int>& affinity_mask = {});
+    /**
+     * @brief Add a block group with all of its properties, e.g. a spin budget
+     *
+     * @param bgp
+     */
+    void add_block_group(const block_group_properties& bgp);
+
+    void set_perf_counters(bool enable) override;
+    block_profile perf_counters() override;
+    void set_tracing(bool enable) override;
+    std::vector<trace_event> trace_events() override;
+
+    /**
+     * @brief Group the blocks not in an explicit block group using auto_partitioner
+     *
+     * Must be called before initialize
+     *
+     * @param profile block costs, e.g. from perf_counters() of a previous run
+     * @param max_threads 0 for the number of hardware threads
+     */
+    void set_auto_partition(const block_profile& profile = {}, size_t max_threads = 0);
+
+    /**
+     * @brief Block groups, including the ones made by the auto partitioner once
+     * initialized
+     *
+     */
+    std::vector<block_group_properties>& block_groups() { return _block_groups; }
 
     /**
      * @brief Initialize the multi-threaded scheduler
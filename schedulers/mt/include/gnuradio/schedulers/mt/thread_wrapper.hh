@@ -2,14 +2,19 @@
 
 #include <gnuradio/block_group_properties.hh>
 #include <gnuradio/block.hh>
-#include <gnuradio/concurrent_queue.hh>
 #include <gnuradio/flowgraph_monitor.hh>
+#include <gnuradio/mpsc_queue.hh>
 #include <gnuradio/neighbor_interface.hh>
 #include <gnuradio/neighbor_interface_info.hh>
 #include <gnuradio/scheduler_message.hh>
+#include <gnuradio/trace_event.hh>
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <thread>
 
 #include "graph_executor.hh"
+#include "trace_ring.hh"
 
 namespace gr {
 namespace schedulers {
@@ -28,14 +33,45 @@ private:
      * @brief Single message queue for all types of messages to this thread
      *
      */
-    concurrent_queue<scheduler_message_sptr> msgq;
+    mpsc_queue<scheduler_message_sptr> msgq;
+
+    /**
+     * @brief Doorbell for stream notifications from neighboring blocks
+     *
+     * One bit per scheduler_action_t.  Neighbors set bits instead of queueing a message
+     * per work call, and the thread drains the whole mask once per loop, so any number
+     * of notifications between two iterations coalesce into one
+     *
+     */
+    std::atomic<uint32_t> d_doorbell = 0;
+
+    /**
+     * @brief Messages posted by blocks on this thread to blocks on this thread
+     *
+     * Only touched by the thread itself, so delivering them takes no locks, wake-ups or
+     * msgport_message allocations.  They are run from the thread loop rather than from
+     * inside post(), so a callback never runs in the middle of another block's work or
+     * callback
+     *
+     */
+    std::deque<std::pair<const message_port_callback_fcn*, pmtf::pmt_sptr>> d_local_msgs;
+    std::deque<std::pair<const message_port_callback_fcn*, pmtf::pmt_sptr>>
+        d_local_batch; // being handled, kept to reuse its storage
+    std::atomic<std::thread::id> d_thread_id{ std::thread::id() };
     std::thread d_thread;
-    bool d_thread_stopped = false;
+    std::atomic<bool> d_thread_stopped = false;
+
+    // Allocated the first time tracing is enabled, and kept until destruction so the
+    // thread can keep writing to it if tracing is disabled concurrently
+    std::unique_ptr<trace_ring> d_trace;
+    std::atomic<bool> d_tracing = false;
     std::unique_ptr<graph_executor> _exec;
 
     int _id;
     block_group_properties d_block_group;
+    std::chrono::microseconds d_spin_budget;
     std::vector<block_sptr> d_blocks;
+    std::vector<bool> d_done_reported; // DONE sent to the flowgraph monitor
 
     logger_sptr _logger;
     logger_sptr _debug_logger;
@@ -61,7 +97,18 @@ public:
     const std::string& name() { return d_block_group.name(); }
 
     void push_message(scheduler_message_sptr msg) { msgq.push(msg); }
-    bool pop_message(scheduler_message_sptr& msg) { return msgq.pop(msg); }
+    void notify(scheduler_action_t action) override;
+    bool push_local_message(const message_port_callback_fcn& cb,
+                            pmtf::pmt_sptr msg) override;
+    /**
+     * @brief Blocking pop that also returns (false) when the doorbell is rung, parking
+     * right away
+     *
+     */
+    bool wait_message(scheduler_message_sptr& msg)
+    {
+        return msgq.pop(msg, [this] { return d_doorbell.load() != 0; });
+    }
     bool pop_message_nonblocking(scheduler_message_sptr& msg)
     {
         return msgq.try_pop(msg);
@@ -72,7 +119,37 @@ public:
     void wait();
     void run();
 
+    void set_perf_counters(bool enable) { _exec->set_perf_counters(enable); }
+    /**
+     * @brief Add the performance counters of the blocks on this thread to a profile
+     *
+     * @param profile
+     */
+    void add_perf_counters(block_profile& profile);
+
+    /**
+     * @brief Record the activity of this thread into its trace ring
+     *
+     * Does nothing unless the scheduler is built with GR_ENABLE_TRACING
+     *
+     * @param enable
+     */
+    void set_tracing(bool enable);
+    /**
+     * @brief Events recorded by this thread, safe to call while it runs
+     *
+     * @param pid trace process id, i.e. the scheduler
+     * @return std::vector<trace_event>
+     */
+    std::vector<trace_event> trace_events(int pid);
+
+    /**
+     * @brief Wait for a message or a doorbell ring for up to the spin budget
+     *
+     */
+    void spin();
     bool handle_work_notification();
+    void handle_local_messages();
     static void thread_body(thread_wrapper* top);
 };
 } // namespace schedulers
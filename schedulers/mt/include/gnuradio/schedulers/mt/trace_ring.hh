@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace gr {
+namespace schedulers {
+
+enum class trace_event_t : uint8_t {
+    WORK,            // work call of a block, with duration
+    BLOCKED_IN,      // block became blocked on input
+    BLOCKED_OUT,     // block became blocked on output
+    NOTIFY_SENT,     // notification rung on another thread
+    NOTIFY_RECEIVED, // doorbell drained by this thread
+    PARKED,          // thread waiting for messages, with duration
+    SPINNING,        // thread polling for messages before parking, with duration
+};
+
+/**
+ * @brief Fixed size ring of scheduler events written by a single thread
+ *
+ * Recording an event is a few plain stores and one release store of the head, with no
+ * locks or allocations.  When the ring is full the oldest events are overwritten.
+ * events() can be called while the writing thread runs - it drops the slots that may
+ * have been overwritten while it copied them.
+ *
+ * Only built into the scheduler with the enable_tracing option (GR_ENABLE_TRACING), so
+ * that the record sites cost nothing otherwise.
+ *
+ */
+class trace_ring
+{
+public:
+    struct event {
+        uint64_t ts_ns;
+        uint64_t dur_ns;
+        uint32_t id; // block id, peer thread or doorbell mask, depending on the type
+        trace_event_t type;
+    };
+
+    trace_ring(size_t capacity = 65536)
+    {
+        size_t n = 1;
+        while (n < capacity) {
+            n <<= 1;
+        }
+        d_events.resize(n);
+        d_mask = n - 1;
+    }
+
+    static uint64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    void record(trace_event_t type, uint32_t id, uint64_t ts_ns, uint64_t dur_ns = 0)
+    {
+        auto head = d_head.load(std::memory_order_relaxed);
+        d_events[head & d_mask] = { ts_ns, dur_ns, id, type };
+        d_head.store(head + 1, std::memory_order_release);
+    }
+    void record(trace_event_t type, uint32_t id) { record(type, id, now()); }
+
+    /**
+     * @brief Recorded events, oldest first
+     *
+     */
+    std::vector<event> events() const
+    {
+        auto head = d_head.load(std::memory_order_acquire);
+        auto start = head > d_events.size() ? head - d_events.size() : 0;
+        std::vector<event> ret;
+        ret.reserve(head - start);
+        for (auto i = start; i < head; i++) {
+            ret.push_back(d_events[i & d_mask]);
+        }
+
+        // Like a seqlock read: the writer may have moved on while we copied.  Slot i is
+        // reused by event i + size, and the writer fills the slot of the head before
+        // publishing it, so only the events after head_now - size are known to be intact
+        std::atomic_thread_fence(std::memory_order_acquire);
+        auto head_now = d_head.load(std::memory_order_relaxed);
+        if (head_now + 1 > start + d_events.size()) {
+            auto torn = std::min<uint64_t>(head_now + 1 - d_events.size() - start,
+                                           ret.size());
+            ret.erase(ret.begin(), ret.begin() + torn);
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Ring of the calling scheduler thread, null when it is not tracing
+     *
+     */
+    static trace_ring*& current()
+    {
+        thread_local trace_ring* ring = nullptr;
+        return ring;
+    }
+
+private:
+    std::vector<event> d_events;
+    size_t d_mask;
+    std::atomic<uint64_t> d_head = 0;
+};
+
+} // namespace schedulers
+} // namespace gr
+
+// Record sites compile to nothing without GR_ENABLE_TRACING, and cost a thread_local
+// load and a branch when tracing is compiled in but disabled
+#ifdef GR_ENABLE_TRACING
+#define GR_TRACE(type, id)                                                      \
+    do {                                                                         \
+        if (auto _ring = gr::schedulers::trace_ring::current()) {                \
+            _ring->record(gr::schedulers::trace_event_t::type, id);             \
+        }                                                                        \
+    } while (0)
+#define GR_TRACE_BEGIN(span)                                                    \
+    auto _trace_ring_##span = gr::schedulers::trace_ring::current();             \
+    uint64_t _trace_start_##span =                                               \
+        _trace_ring_##span ? gr::schedulers::trace_ring::now() : 0
+#define GR_TRACE_END(span, type, id)                                            \
+    do {                                                                         \
+        if (_trace_ring_##span) {                                                \
+            _trace_ring_##span->record(gr::schedulers::trace_event_t::type,     \
+                                       id,                                       \
+                                       _trace_start_##span,                      \
+                                       gr::schedulers::trace_ring::now() -       \
+                                           _trace_start_##span);                 \
+        }                                                                        \
+    } while (0)
+#else
+#define GR_TRACE(type, id) \
+    do {                   \
+    } while (0)
+#define GR_TRACE_BEGIN(span)
+#define GR_TRACE_END(span, type, id) \
+    do {                             \
+    } while (0)
+#endif
@@ -0,0 +1,231 @@
+#include "auto_partitioner.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+namespace gr {
+namespace schedulers {
+
+auto_partitioner::auto_partitioner(const block_profile& profile, size_t max_threads)
+    : d_profile(profile), d_max_threads(max_threads)
+{
+    if (d_max_threads == 0) {
+        d_max_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+std::vector<block_group_properties>
+auto_partitioner::partition(flat_graph_sptr fg, const std::vector<block_sptr>& blocks)
+{
+    if (blocks.empty()) {
+        return {};
+    }
+
+    size_t n = blocks.size();
+
+    std::map<nodeid_t, size_t> index;
+    std::vector<double> weight(n, -1);
+    std::vector<double> known;
+    for (size_t i = 0; i < n; i++) {
+        index[blocks[i]->id()] = i;
+        auto it = d_profile.find(blocks[i]->alias());
+        if (it != d_profile.end()) {
+            weight[i] = it->second.work_ns;
+            known.push_back(weight[i]);
+        }
+    }
+    double fallback = 1.0;
+    if (!known.empty()) {
+        std::nth_element(known.begin(), known.begin() + known.size() / 2, known.end());
+        fallback = known[known.size() / 2];
+    }
+    for (auto& w : weight) {
+        if (w < 0) {
+            w = fallback;
+        }
+    }
+
+    std::vector<std::pair<size_t, size_t>> edges;
+    for (auto& e : fg->edges()) {
+        auto src = index.find(e->src().node()->id());
+        auto dst = index.find(e->dst().node()->id());
+        if (src != index.end() && dst != index.end() && src->second != dst->second) {
+            edges.emplace_back(src->second, dst->second);
+        }
+    }
+
+    double total = std::accumulate(weight.begin(), weight.end(), 0.0);
+    double share = total / d_max_threads;
+
+    // Union-find over the blocks, the root of each set holding the group weight
+    std::vector<size_t> parent(n);
+    std::iota(parent.begin(), parent.end(), 0);
+    std::vector<double> group_weight = weight;
+    auto find = [&parent](size_t i) {
+        while (parent[i] != i) {
+            i = parent[i] = parent[parent[i]];
+        }
+        return i;
+    };
+    auto merge = [&](size_t ra, size_t rb) {
+        parent[rb] = ra;
+        group_weight[ra] += group_weight[rb];
+    };
+
+    // Cheap neighbors first, never growing a group past its fair share
+    std::stable_sort(edges.begin(), edges.end(), [&weight](auto& a, auto& b) {
+        return weight[a.first] + weight[a.second] < weight[b.first] + weight[b.second];
+    });
+    for (auto& [a, b] : edges) {
+        auto ra = find(a);
+        auto rb = find(b);
+        if (ra == rb || weight[a] >= share || weight[b] >= share) {
+            continue;
+        }
+        if (group_weight[ra] + group_weight[rb] <= share) {
+            merge(ra, rb);
+        }
+    }
+
+    // Then fit the groups onto max_threads, merging the lightest connected pairs (or
+    // the two lightest groups if none are connected)
+    auto roots = [&]() {
+        std::vector<size_t> r;
+        for (size_t i = 0; i < n; i++) {
+            if (find(i) == i) {
+                r.push_back(i);
+            }
+        }
+        return r;
+    };
+    for (auto r = roots(); r.size() > d_max_threads; r = roots()) {
+        size_t best_a = n, best_b = n;
+        double best_w = 0;
+        for (auto& [a, b] : edges) {
+            auto ra = find(a);
+            auto rb = find(b);
+            auto w = group_weight[ra] + group_weight[rb];
+            if (ra != rb && (best_a == n || w < best_w)) {
+                best_a = ra;
+                best_b = rb;
+                best_w = w;
+            }
+        }
+        if (best_a == n) {
+            std::partial_sort(r.begin(), r.begin() + 2, r.end(), [&](size_t a, size_t b) {
+                return group_weight[a] < group_weight[b];
+            });
+            best_a = r[0];
+            best_b = r[1];
+        }
+        merge(best_a, best_b);
+    }
+
+    // Groups in order of their first block, blocks in topological order
+    std::vector<std::vector<block_sptr>> members(n);
+    std::vector<size_t> order;
+    for (size_t i = 0; i < n; i++) {
+        auto r = find(i);
+        if (members[r].empty()) {
+            order.push_back(r);
+        }
+        members[r].push_back(blocks[i]);
+    }
+
+    std::vector<block_group_properties> groups;
+    for (auto r : order) {
+        groups.emplace_back(members[r], "auto" + std::to_string(groups.size()));
+    }
+    return groups;
+}
+
+void auto_partitioner::save_profile(const std::string& path, const block_profile& profile)
+{
+    std::ofstream ofs(path);
+    if (!ofs) {
+        throw std::runtime_error("Unable to write block profile " + path);
+    }
+    for (auto& [alias, c] : profile) {
+        ofs << alias << " " << c.work_calls << " " << c.items_in << " " << c.items_out
+            << " " << c.work_ns << " " << c.work_ns_min << " " << c.work_ns_max << " "
+            << c.blocked_in << " " << c.blocked_out << " " << c.input_fullness << " "
+            << c.output_fullness << std::endl;
+    }
+}
+
+block_profile auto_partitioner::load_profile(const std::string& path)
+{
+    std::ifstream ifs(path);
+    if (!ifs) {
+        throw std::runtime_error("Unable to read block profile " + path);
+    }
+    block_profile profile;
+    std::string alias;
+    block_perf_counters c;
+    while (ifs >> alias >> c.work_calls >> c.items_in >> c.items_out >> c.work_ns >>
+           c.work_ns_min >> c.work_ns_max >> c.blocked_in >> c.blocked_out >>
+           c.input_fullness >> c.output_fullness) {
+        profile[alias] = c;
+    }
+    return profile;
+}
+
+void auto_partitioner::save_groups(const std::string& path,
+                                   std::vector<block_group_properties>& groups)
+{
+    std::ofstream ofs(path);
+    if (!ofs) {
+        throw std::runtime_error("Unable to write block groups " + path);
+    }
+    for (auto& g : groups) {
+        ofs << g.name();
+        for (auto& b : g.blocks()) {
+            ofs << " " << b->alias();
+        }
+        ofs << std::endl;
+    }
+}
+
+std::vector<block_group_properties>
+auto_partitioner::load_groups(const std::string& path,
+                              const std::vector<block_sptr>& blocks)
+{
+    std::ifstream ifs(path);
+    if (!ifs) {
+        throw std::runtime_error("Unable to read block groups " + path);
+    }
+
+    std::map<std::string, block_sptr> by_alias;
+    for (auto& b : blocks) {
+        by_alias[b->alias()] = b;
+    }
+
+    std::vector<block_group_properties> groups;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        std::istringstream iss(line);
+        std::string name, alias;
+        if (!(iss >> name)) {
+            continue;
+        }
+        std::vector<block_sptr> group;
+        while (iss >> alias) {
+            auto it = by_alias.find(alias);
+            if (it == by_alias.end()) {
+                throw std::runtime_error("Block group " + name + " refers to unknown block " +
+                                         alias);
+            }
+            group.push_back(it->second);
+        }
+        if (!group.empty()) {
+            groups.emplace_back(group, name);
+        }
+    }
+    return groups;
+}
+
+} // namespace schedulers
+} // namespace gr
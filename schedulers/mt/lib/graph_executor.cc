@@ -1,4 +1,6 @@
 #include "graph_executor.hh"
+#include "trace_ring.hh"
+#include <chrono>
 
 namespace gr {
 namespace schedulers {
@@ -8,231 +10,460 @@ inline static unsigned int round_down(unsigned int n, unsigned int multiple)
     return (n / multiple) * multiple;
 }
 
-std::map<nodeid_t, executor_iteration_status>
-graph_executor::run_one_iteration(std::vector<block_sptr> blocks)
+void graph_executor::initialize(buffer_manager::sptr bufman,
+                                std::vector<block_sptr> blocks)
 {
-    std::map<nodeid_t, executor_iteration_status> per_block_status;
+    _bufman = bufman;
+    d_blocks = blocks;
+
+    d_plans.clear();
+    d_plans.reserve(d_blocks.size());
+    d_counters = std::vector<counter_set>(d_blocks.size());
+    for (auto& b : d_blocks) {
+        block_plan plan;
+        plan.blk = b;
+        plan.counters = &d_counters[d_plans.size()];
+        plan.stream =
+            !b->input_stream_ports().empty() || !b->output_stream_ports().empty();
+        // Optional ports left unconnected have no buffer, and work sees only the others
+        for (auto& p : b->input_stream_ports()) {
+            if (!p->connected_ports().empty()) {
+                plan.input_ports.push_back(p);
+            }
+        }
+        for (auto& p : b->output_stream_ports()) {
+            if (!p->connected_ports().empty()) {
+                plan.output_ports.push_back(p);
+            }
+        }
+        for (auto& p : plan.input_ports) {
+            plan.work_input.push_back(block_work_input(0, p->buffer_reader()));
+            plan.input_capacity.push_back(p->buffer_reader()->buffer_num_items());
+        }
+        for (auto& p : plan.output_ports) {
+            plan.work_output.push_back(block_work_output(0, p->buffer()));
+            plan.output_capacity.push_back(p->buffer()->num_items());
+        }
+        for (auto& p : plan.input_ports) {
+            p->set_finished(false);
+        }
+        for (auto& p : plan.output_ports) {
+            p->set_finished(false);
+        }
+        d_plans.push_back(std::move(plan));
+    }
 
-    // If no blocks are specified for the iteration, then run over all the blocks
-    // in the default ordering
-    if (blocks.empty()) {
-        blocks = d_blocks;
+    d_status.assign(d_blocks.size(), executor_iteration_status::READY);
+    for (size_t i = 0; i < d_plans.size(); i++) {
+        if (!d_plans[i].stream) {
+            // Driven by its message handlers alone, so it is never ready for work
+            d_status[i] = executor_iteration_status::BLKD_IN;
+        }
     }
+}
 
-    for (auto const& b : blocks) { // TODO - order the blocks
+block_perf_counters graph_executor::perf_counters(size_t idx) const
+{
+    auto& c = d_counters.at(idx);
+    block_perf_counters ret;
+    ret.work_calls = c.work_calls.load(std::memory_order_relaxed);
+    ret.items_in = c.items_in.load(std::memory_order_relaxed);
+    ret.items_out = c.items_out.load(std::memory_order_relaxed);
+    ret.work_ns = c.work_ns.load(std::memory_order_relaxed);
+    ret.work_ns_max = c.work_ns_max.load(std::memory_order_relaxed);
+    ret.blocked_in = c.blocked_in.load(std::memory_order_relaxed);
+    ret.blocked_out = c.blocked_out.load(std::memory_order_relaxed);
+    if (ret.work_calls) {
+        ret.work_ns_min = c.work_ns_min.load(std::memory_order_relaxed);
+        ret.input_fullness =
+            c.input_fullness_ppm.load(std::memory_order_relaxed) / 1e6 / ret.work_calls;
+        ret.output_fullness =
+            c.output_fullness_ppm.load(std::memory_order_relaxed) / 1e6 / ret.work_calls;
+    }
+    return ret;
+}
 
-        std::vector<block_work_input> work_input;   //(num_input_ports);
-        std::vector<block_work_output> work_output; //(num_output_ports);
+// Only the executing thread writes the counters, so a relaxed load and store is enough
+// and cheaper than a read-modify-write
+static inline void add(std::atomic<uint64_t>& c, uint64_t n)
+{
+    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
 
-        // for each input port of the block
-        bool ready = true;
-        for (auto p : b->input_stream_ports()) {
-            auto p_buf = p->buffer_reader();
-            auto max_read = p_buf->max_buffer_read();
-            auto min_read = p_buf->min_buffer_read();
+void graph_executor::count_blocked(block_plan& plan, executor_iteration_status status)
+{
+    if (status == executor_iteration_status::BLKD_IN) {
+        add(plan.counters->blocked_in, 1);
+    } else if (status == executor_iteration_status::BLKD_OUT) {
+        add(plan.counters->blocked_out, 1);
+    }
+}
 
-            buffer_info_t read_info;
-            ready = p_buf->read_info(read_info);
-            GR_LOG_DEBUG(
-                _debug_logger, "read_info {} - {} - {}", b->alias(), read_info.n_items, read_info.item_size);
+void graph_executor::count_work(block_plan& plan,
+                                uint64_t ns,
+                                uint64_t input_ppm,
+                                uint64_t output_ppm,
+                                work_return_code_t ret)
+{
+    auto& c = *plan.counters;
+    add(c.work_calls, 1);
+    add(c.work_ns, ns);
+    if (ns < c.work_ns_min.load(std::memory_order_relaxed)) {
+        c.work_ns_min.store(ns, std::memory_order_relaxed);
+    }
+    if (ns > c.work_ns_max.load(std::memory_order_relaxed)) {
+        c.work_ns_max.store(ns, std::memory_order_relaxed);
+    }
+    add(c.input_fullness_ppm, input_ppm);
+    add(c.output_fullness_ppm, output_ppm);
 
-            if (!ready)
-                break;
+    if (ret == work_return_code_t::WORK_OK || ret == work_return_code_t::WORK_DONE) {
+        if (!plan.work_input.empty() && plan.work_input[0].n_consumed > 0) {
+            add(c.items_in, plan.work_input[0].n_consumed);
+        }
+        if (!plan.work_output.empty() && plan.work_output[0].n_produced > 0) {
+            add(c.items_out, plan.work_output[0].n_produced);
+        }
+    }
+}
 
-            if (read_info.n_items < s_min_items_to_process ||
-                (min_read > 0 && read_info.n_items < (int)min_read)) {
+const std::vector<executor_iteration_status>& graph_executor::run_one_iteration()
+{
+    bool counting = d_perf_counters.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < d_plans.size(); i++) { // blocks are given in topological order
+        if (d_plans[i].finished || !d_plans[i].stream) {
+            continue; // stays DONE, or has no work to run
+        }
+        auto prev = d_status[i];
+        d_status[i] = run_block(d_plans[i]);
+        if (counting) {
+            count_blocked(d_plans[i], d_status[i]);
+        }
+        d_status[i] = end_of_stream(d_plans[i], d_status[i]);
+        if (d_status[i] == executor_iteration_status::DONE) {
+            finish(d_plans[i]);
+        }
+        if (d_status[i] != prev) {
+            if (d_status[i] == executor_iteration_status::BLKD_IN) {
+                GR_TRACE(BLOCKED_IN, d_blocks[i]->id());
+            } else if (d_status[i] == executor_iteration_status::BLKD_OUT) {
+                GR_TRACE(BLOCKED_OUT, d_blocks[i]->id());
+            }
+        }
+    }
 
-                p_buf->input_blocked_callback(s_min_items_to_process);
+    return d_status;
+}
 
-                ready = false;
-                break;
-            }
+// Whether the blocks at the other end of the port are all finished - never true for a
+// port with nothing at the other end
+static bool connected_finished(const port_sptr& p)
+{
+    auto& connected = p->connected_ports();
+    if (connected.empty()) {
+        return false;
+    }
+    for (auto& c : connected) {
+        if (!c->finished()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+executor_iteration_status graph_executor::end_of_stream(block_plan& plan,
+                                                        executor_iteration_status status)
+{
+    if (status == executor_iteration_status::READY ||
+        status == executor_iteration_status::DONE) {
+        return status;
+    }
+
+    // Nothing reads the output anymore
+    if (!plan.output_ports.empty()) {
+        bool all_finished = true;
+        for (auto& p : plan.output_ports) {
+            all_finished = all_finished && connected_finished(p);
+        }
+        if (all_finished) {
+            return executor_iteration_status::DONE;
+        }
+    }
+
+    if (status != executor_iteration_status::BLKD_IN || plan.input_ports.empty()) {
+        return status;
+    }
 
-            if (max_read > 0 && read_info.n_items > (int)max_read) {
-                read_info.n_items = max_read;
+    // The flag is set after the last write upstream, so once it is seen an empty buffer
+    // stays empty
+    bool all_finished = true;
+    for (size_t j = 0; j < plan.input_ports.size(); j++) {
+        if (connected_finished(plan.input_ports[j])) {
+            if (plan.work_input[j].buffer->items_available() == 0) {
+                return executor_iteration_status::DONE;
             }
+        } else {
+            all_finished = false;
+        }
+    }
 
+    // Items are left over but no more are coming.  The block may have been blocked on
+    // items that were written just before the flag, so give it one more pass - if it is
+    // still blocked the leftovers are too few for a work call
+    if (all_finished) {
+        status = run_block(plan);
+        if (status == executor_iteration_status::BLKD_IN) {
+            return executor_iteration_status::DONE;
+        }
+    }
+    return status;
+}
 
-            auto tags = p_buf->get_tags(read_info.n_items);
-            work_input.push_back(block_work_input(read_info.n_items, p_buf));
+void graph_executor::finish(block_plan& plan)
+{
+    plan.finished = true;
+    for (auto& p : plan.input_ports) {
+        p->set_finished(true);
+    }
+    for (auto& p : plan.output_ports) {
+        p->set_finished(true);
+    }
+    // Wake the neighbors so they see the end of stream
+    for (auto& p : plan.input_ports) {
+        p->notify_connected_ports(scheduler_action_t::NOTIFY_ALL);
+    }
+    for (auto& p : plan.output_ports) {
+        p->notify_connected_ports(scheduler_action_t::NOTIFY_ALL);
+    }
+}
+
+executor_iteration_status graph_executor::run_block(block_plan& plan)
+{
+    auto& b = plan.blk;
+    auto& work_input = plan.work_input;
+    auto& work_output = plan.work_output;
+
+    bool counting = d_perf_counters.load(std::memory_order_relaxed);
+    uint64_t input_ppm = 0, output_ppm = 0;
+
+    // for each input port of the block
+    bool ready = true;
+    for (auto& w : work_input) {
+        auto& p_buf = w.buffer;
+        auto max_read = p_buf->max_buffer_read();
+        auto min_read = p_buf->min_buffer_read();
+
+        buffer_info_t read_info;
+        ready = p_buf->read_info(read_info);
+        GR_LOG_DEBUG(
+            _debug_logger, "read_info {} - {} - {}", b->alias(), read_info.n_items, read_info.item_size);
+
+        if (!ready)
+            break;
+
+        if (read_info.n_items < s_min_items_to_process ||
+            (min_read > 0 && read_info.n_items < (int)min_read)) {
+
+            p_buf->input_blocked_callback(s_min_items_to_process);
+
+            ready = false;
+            break;
         }
 
-        if (!ready) {
-            per_block_status[b->id()] = executor_iteration_status::BLKD_IN;
-            continue;
+        if (counting) {
+            auto cap = plan.input_capacity[&w - &work_input[0]];
+            input_ppm += (uint64_t)read_info.n_items * 1000000 / cap / work_input.size();
         }
 
-        // for each output port of the block
-        for (auto p : b->output_stream_ports()) {
+        if (max_read > 0 && read_info.n_items > (int)max_read) {
+            read_info.n_items = max_read;
+        }
 
-            // When a block has multiple output buffers, it adds the restriction
-            // that the work call can only produce the minimum available across
-            // the buffers.
+        w.n_items = read_info.n_items;
+        w.n_consumed = -1;
+    }
 
-            size_t max_output_buffer = std::numeric_limits<int>::max();
+    if (!ready) {
+        return executor_iteration_status::BLKD_IN;
+    }
 
-            auto p_buf = p->buffer();
-            auto max_fill = p_buf->max_buffer_fill();
-            auto min_fill = p_buf->min_buffer_fill();
+    // for each output port of the block
+    for (auto& w : work_output) {
+
+        // When a block has multiple output buffers, it adds the restriction
+        // that the work call can only produce the minimum available across
+        // the buffers.
+
+        size_t max_output_buffer = std::numeric_limits<int>::max();
+
+        auto& p_buf = w.buffer;
+        auto max_fill = p_buf->max_buffer_fill();
+        auto min_fill = p_buf->min_buffer_fill();
+
+        buffer_info_t write_info;
+        ready = p_buf->write_info(write_info);
+        GR_LOG_DEBUG(_debug_logger,
+                     "write_info {} - {} @ {} {}",
+                     b->alias(),
+                     write_info.n_items,
+                     write_info.ptr,
+                     write_info.item_size);
+
+        size_t tmp_buf_size = write_info.n_items;
+        if (tmp_buf_size < s_min_buf_items ||
+            (min_fill > 0 && tmp_buf_size < min_fill)) {
+            ready = false;
+            p_buf->output_blocked_callback(false);
+            break;
+        }
 
-            buffer_info_t write_info;
-            ready = p_buf->write_info(write_info);
-            GR_LOG_DEBUG(_debug_logger,
-                         "write_info {} - {} @ {} {}",
-                         b->alias(),
-                         write_info.n_items,
-                         write_info.ptr,
-                         write_info.item_size);
-
-            size_t tmp_buf_size = write_info.n_items;
-            if (tmp_buf_size < s_min_buf_items ||
-                (min_fill > 0 && tmp_buf_size < min_fill)) {
-                ready = false;
-                p_buf->output_blocked_callback(false);
-                break;
-            }
+        if (counting) {
+            auto cap = plan.output_capacity[&w - &work_output[0]];
+            output_ppm +=
+                (uint64_t)(cap - std::min(cap, tmp_buf_size)) * 1000000 / cap /
+                work_output.size();
+        }
 
-            if (tmp_buf_size < max_output_buffer)
-                max_output_buffer = tmp_buf_size;
+        if (tmp_buf_size < max_output_buffer)
+            max_output_buffer = tmp_buf_size;
 
-            if (max_fill > 0 && max_output_buffer > max_fill) {
-                max_output_buffer = max_fill;
-            }
+        if (max_fill > 0 && max_output_buffer > max_fill) {
+            max_output_buffer = max_fill;
+        }
 
-            if (b->output_multiple_set()) {
-                max_output_buffer = round_down(max_output_buffer, b->output_multiple());
-            }
+        if (b->output_multiple_set()) {
+            max_output_buffer = round_down(max_output_buffer, b->output_multiple());
+        }
 
-            if (max_output_buffer <= 0) {
-                ready = false;
-            }
+        if (max_output_buffer <= 0) {
+            ready = false;
+        }
 
-            if (!ready)
-                break;
+        if (!ready)
+            break;
+
+        w.n_items = max_output_buffer;
+        w.n_produced = -1;
+    }
+
+    if (!ready) {
+        return executor_iteration_status::BLKD_OUT;
+    }
 
+    // steady_clock is read through the vDSO on Linux, without a system call
+    std::chrono::steady_clock::time_point t_start;
+    if (counting) {
+        t_start = std::chrono::steady_clock::now();
+    }
 
-            std::vector<tag_t> tags; // needs to be associated with edge buffers
+    GR_TRACE_BEGIN(work);
+    executor_iteration_status status = executor_iteration_status::READY;
+    work_return_code_t ret;
+    while (true) {
 
-            work_output.push_back(block_work_output(max_output_buffer, p_buf));
+        if (work_output.size() > 0) {
+            GR_LOG_DEBUG(_debug_logger,
+                         "do_work for {}, {}",
+                         b->alias(),
+                         work_output[0].n_items);
+        } else {
+            GR_LOG_DEBUG(_debug_logger, "do_work for {}", b->alias());
         }
 
-        if (!ready) {
-            per_block_status[b->id()] = executor_iteration_status::BLKD_OUT;
-            continue;
+
+        ret = b->do_work(work_input, work_output);
+        GR_LOG_DEBUG(_debug_logger, "do_work returned {}", ret);
+        // ret = work_return_code_t::WORK_OK;
+
+        if (ret == work_return_code_t::WORK_DONE) {
+            status = executor_iteration_status::DONE;
+            break;
+        } else if (ret == work_return_code_t::WORK_OK) {
+            status = executor_iteration_status::READY;
+            break;
+        } else if (ret == work_return_code_t::WORK_INSUFFICIENT_INPUT_ITEMS) {
+            if (b->output_multiple_set()) {
+                work_output[0].n_items -= b->output_multiple();
+            } else {
+                work_output[0].n_items >>= 1;
+            }
+            if (work_output[0].n_items < b->output_multiple()) // min block size
+            {
+                status = executor_iteration_status::BLKD_IN;
+                // call the input blocked callback
+                break;
+            }
+        } else if (ret == work_return_code_t::WORK_INSUFFICIENT_OUTPUT_ITEMS) {
+            status = executor_iteration_status::BLKD_OUT;
+            // call the output blocked callback
+            break;
         }
+    }
+    // TODO - handle READY_NO_OUTPUT
+    GR_TRACE_END(work, WORK, b->id());
+
+    if (counting) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - t_start)
+                      .count();
+        count_work(plan, ns, input_ppm, output_ppm, ret);
+    }
 
-        if (ready) {
-            work_return_code_t ret;
-            while (true) {
+    if (ret == work_return_code_t::WORK_OK ||
+        ret == work_return_code_t::WORK_DONE) {
 
-                if (work_output.size() > 0) {
-                    GR_LOG_DEBUG(_debug_logger,
-                                 "do_work for {}, {}",
-                                 b->alias(),
-                                 work_output[0].n_items);
-                } else {
-                    GR_LOG_DEBUG(_debug_logger, "do_work for {}", b->alias());
-                }
 
+        int input_port_index = 0;
+        for (auto& p : plan.input_ports) {
+            auto& p_buf = work_input[input_port_index].buffer;
 
-                ret = b->do_work(work_input, work_output);
-                GR_LOG_DEBUG(_debug_logger, "do_work returned {}", ret);
-                // ret = work_return_code_t::WORK_OK;
-
-                if (ret == work_return_code_t::WORK_DONE) {
-                    per_block_status[b->id()] = executor_iteration_status::DONE;
-                    break;
-                } else if (ret == work_return_code_t::WORK_OK) {
-                    per_block_status[b->id()] = executor_iteration_status::READY;
-                    break;
-                } else if (ret == work_return_code_t::WORK_INSUFFICIENT_INPUT_ITEMS) {
-                    if (b->output_multiple_set()) {
-                        work_output[0].n_items -= b->output_multiple();
-                    } else {
-                        work_output[0].n_items >>= 1;
+            if (p_buf->has_tags()) {
+                // Pass the tags according to TPP
+                if (b->tag_propagation_policy() ==
+                    tag_propagation_policy_t::TPP_ALL_TO_ALL) {
+                    for (auto& w : work_output) {
+                        w.buffer->propagate_tags(
+                            p_buf, work_input[input_port_index].n_consumed);
                     }
-                    if (work_output[0].n_items < b->output_multiple()) // min block size
-                    {
-                        per_block_status[b->id()] = executor_iteration_status::BLKD_IN;
-                        // call the input blocked callback
-                        break;
+                } else if (b->tag_propagation_policy() ==
+                           tag_propagation_policy_t::TPP_ONE_TO_ONE) {
+                    if (input_port_index < (int)work_output.size()) {
+                        work_output[input_port_index].buffer->propagate_tags(
+                            p_buf, work_input[input_port_index].n_consumed);
                     }
-                } else if (ret == work_return_code_t::WORK_INSUFFICIENT_OUTPUT_ITEMS) {
-                    per_block_status[b->id()] = executor_iteration_status::BLKD_OUT;
-                    // call the output blocked callback
-                    break;
                 }
             }
-            // TODO - handle READY_NO_OUTPUT
-
-            if (ret == work_return_code_t::WORK_OK ||
-                ret == work_return_code_t::WORK_DONE) {
-
-
-                int input_port_index = 0;
-                for (auto p : b->input_stream_ports()) {
-                    auto p_buf = p->buffer_reader();
-
-                    if (!p_buf->tags().empty()) {
-                        // Pass the tags according to TPP
-                        if (b->tag_propagation_policy() ==
-                            tag_propagation_policy_t::TPP_ALL_TO_ALL) {
-                            int output_port_index = 0;
-                            for (auto op : b->output_stream_ports()) {
-                                auto p_out_buf = op->buffer();
-                                p_out_buf->propagate_tags(
-                                    p_buf, work_input[input_port_index].n_consumed);
-
-                                output_port_index++;
-                            }
-                        } else if (b->tag_propagation_policy() ==
-                                   tag_propagation_policy_t::TPP_ONE_TO_ONE) {
-                            int output_port_index = 0;
-                            for (auto op : b->output_stream_ports()) {
-                                if (output_port_index == input_port_index) {
-                                    auto p_out_buf = op->buffer();
-                                    p_out_buf->propagate_tags(
-                                        p_buf, work_input[input_port_index].n_consumed);
-                                }
-                                output_port_index++;
-                            }
-                        }
-                    }
 
-                    GR_LOG_DEBUG(_debug_logger,
-                                 "post_read {} - {}",
-                                 b->alias(),
-                                 work_input[input_port_index].n_consumed);
+            GR_LOG_DEBUG(_debug_logger,
+                         "post_read {} - {}",
+                         b->alias(),
+                         work_input[input_port_index].n_consumed);
 
-                    p_buf->post_read(work_input[input_port_index].n_consumed);
-                    p->notify_connected_ports(std::make_shared<scheduler_action>(
-                        scheduler_action_t::NOTIFY_OUTPUT));
+            p_buf->post_read(work_input[input_port_index].n_consumed);
+            p->notify_connected_ports(scheduler_action_t::NOTIFY_OUTPUT);
 
-                    input_port_index++;
-                }
+            input_port_index++;
+        }
 
-                int output_port_index = 0;
-                for (auto p : b->output_stream_ports()) {
-                    auto p_buf = p->buffer();
+        int output_port_index = 0;
+        for (auto& p : plan.output_ports) {
+            auto& p_buf = work_output[output_port_index].buffer;
 
-                    GR_LOG_DEBUG(_debug_logger,
-                                 "post_write {} - {}",
-                                 b->alias(),
-                                 work_output[output_port_index].n_produced);
-                    p_buf->post_write(work_output[output_port_index].n_produced);
+            GR_LOG_DEBUG(_debug_logger,
+                         "post_write {} - {}",
+                         b->alias(),
+                         work_output[output_port_index].n_produced);
+            p_buf->post_write(work_output[output_port_index].n_produced);
 
-                    p->notify_connected_ports(std::make_shared<scheduler_action>(
-                        scheduler_action_t::NOTIFY_INPUT));
+            p->notify_connected_ports(scheduler_action_t::NOTIFY_INPUT);
 
-                    output_port_index++;
+            output_port_index++;
 
-                    p_buf->prune_tags();
-                }
-            }
+            p_buf->prune_tags();
         }
     }
 
-    return per_block_status;
+    return status;
 }
 
 } // namespace schedulers
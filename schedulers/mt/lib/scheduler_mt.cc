@@ -24,6 +24,59 @@ void scheduler_mt::add_block_group(const std::vector<block_sptr>& blocks,
         std::move(block_group_properties(blocks, name, affinity_mask)));
 }
 
+void scheduler_mt::add_block_group(const block_group_properties& bgp)
+{
+    _block_groups.push_back(bgp);
+}
+
+void scheduler_mt::set_perf_counters(bool enable)
+{
+    _perf_counters = enable;
+    for (auto& thd : _threads) {
+        thd->set_perf_counters(enable);
+    }
+}
+
+block_profile scheduler_mt::perf_counters()
+{
+    block_profile ret;
+    for (auto& thd : _threads) {
+        thd->add_perf_counters(ret);
+    }
+    return ret;
+}
+
+void scheduler_mt::set_tracing(bool enable)
+{
+#ifndef GR_ENABLE_TRACING
+    if (enable) {
+        GR_LOG_WARN(_logger, "Built without tracing support (enable_tracing), not tracing");
+    }
+#endif
+    _tracing = enable;
+    for (auto& thd : _threads) {
+        thd->set_tracing(enable);
+    }
+}
+
+std::vector<trace_event> scheduler_mt::trace_events()
+{
+    std::vector<trace_event> ret;
+    ret.push_back({ "process_name", "", 'M', 0, 0, id(), 0, { { "name", name() } } });
+    for (auto& thd : _threads) {
+        auto e = thd->trace_events(id());
+        ret.insert(ret.end(), e.begin(), e.end());
+    }
+    return ret;
+}
+
+void scheduler_mt::set_auto_partition(const block_profile& profile, size_t max_threads)
+{
+    _auto_partition = true;
+    _auto_profile = profile;
+    _auto_max_threads = max_threads;
+}
+
 void scheduler_mt::initialize(flat_graph_sptr fg, flowgraph_monitor_sptr fgmon)
 {
     for (auto& b : fg->calc_used_blocks()) {
@@ -39,12 +92,57 @@ void scheduler_mt::initialize(flat_graph_sptr fg, flowgraph_monitor_sptr fgmon)
 
     auto blocks = fg->calc_used_blocks();
 
+    // Blocks within a group are executed in stream order so that data produced by one
+    // block can be consumed by the next in the same pass.  Only needed when a thread
+    // runs more than one block
+    bool need_order = _auto_partition;
+    for (auto& bg : _block_groups) {
+        need_order = need_order || bg.blocks().size() > 1;
+    }
+    block_vector_t sorted_blocks = need_order ? fg->stream_order(blocks) : blocks;
+    std::map<nodeid_t, size_t> topo_rank;
+    for (size_t i = 0; need_order && i < sorted_blocks.size(); i++) {
+        topo_rank[sorted_blocks[i]->id()] = i;
+    }
+
+    if (_auto_partition) {
+        // Kept in stream order for the partitioner
+        std::vector<block_sptr> ungrouped;
+        for (auto& b : sorted_blocks) {
+            bool grouped = false;
+            for (auto& bg : _block_groups) {
+                if (std::find(bg.blocks().begin(), bg.blocks().end(), b) !=
+                    bg.blocks().end()) {
+                    grouped = true;
+                    break;
+                }
+            }
+            if (!grouped) {
+                ungrouped.push_back(b);
+            }
+        }
+        auto_partitioner ap(_auto_profile, _auto_max_threads);
+        for (auto& bg : ap.partition(fg, ungrouped)) {
+            _block_groups.push_back(bg);
+        }
+    }
+
     // look at our block groups, create confs and remove from blocks
     for (auto& bg : _block_groups) {
         std::vector<block_sptr> blocks_for_this_thread;
 
         if (bg.blocks().size()) {
+            if (bg.blocks().size() > 1) {
+                std::stable_sort(bg.blocks().begin(),
+                                 bg.blocks().end(),
+                                 [&topo_rank](const block_sptr& a, const block_sptr& b) {
+                                     return topo_rank[a->id()] < topo_rank[b->id()];
+                                 });
+            }
+
             auto t = thread_wrapper::make(id(), bg, bufman, fgmon);
+            t->set_perf_counters(_perf_counters);
+            t->set_tracing(_tracing);
             _threads.push_back(t);
 
             std::vector<node_sptr> node_vec;
@@ -71,6 +169,8 @@ void scheduler_mt::initialize(flat_graph_sptr fg, flowgraph_monitor_sptr fgmon)
         node_vec.push_back(b);
 
         auto t = thread_wrapper::make(id(), block_group_properties({ b }), bufman, fgmon);
+        t->set_perf_counters(_perf_counters);
+        t->set_tracing(_tracing);
         _threads.push_back(t);
 
         for (auto& p : b->all_ports()) {
@@ -1,6 +1,7 @@
 #include "thread_wrapper.hh"
 #include <gnuradio/thread.hh>
 #include <boost/format.hpp>
+#include <map>
 #include <thread>
 
 namespace gr {
@@ -10,7 +11,11 @@ thread_wrapper::thread_wrapper(int id,
                                block_group_properties bgp,
                                buffer_manager::sptr bufman,
                                flowgraph_monitor_sptr fgmon)
-    : _id(id), d_block_group(bgp), d_blocks(bgp.blocks())
+    : _id(id),
+      d_block_group(bgp),
+      d_spin_budget(bgp.spin_budget()),
+      d_blocks(bgp.blocks()),
+      d_done_reported(d_blocks.size(), false)
 {
     _logger = logging::get_logger(bgp.name(), "default");
     _debug_logger = logging::get_logger(bgp.name() + "_dbg", "debug");
@@ -50,26 +55,195 @@ void thread_wrapper::run()
     wait();
 }
 
+void thread_wrapper::add_perf_counters(block_profile& profile)
+{
+    auto& blocks = _exec->blocks();
+    for (size_t i = 0; i < blocks.size(); i++) {
+        profile[blocks[i]->alias()] = _exec->perf_counters(i);
+    }
+}
+
+void thread_wrapper::set_tracing(bool enable)
+{
+#ifdef GR_ENABLE_TRACING
+    if (enable && !d_trace) {
+        d_trace = std::make_unique<trace_ring>();
+    }
+    d_tracing.store(enable, std::memory_order_release);
+#endif
+}
+
+std::vector<trace_event> thread_wrapper::trace_events(int pid)
+{
+    std::vector<trace_event> ret;
+    if (!d_trace) {
+        return ret;
+    }
+
+    int tid = d_blocks[0]->id();
+    std::map<uint32_t, std::string> aliases;
+    for (auto& b : d_blocks) {
+        aliases[b->id()] = b->alias();
+    }
+
+    ret.push_back({ "thread_name", "", 'M', 0, 0, pid, tid, { { "name", name() } } });
+    for (auto& e : d_trace->events()) {
+        switch (e.type) {
+        case trace_event_t::WORK:
+            ret.push_back({ aliases[e.id], "work", 'X', e.ts_ns, e.dur_ns, pid, tid, {} });
+            break;
+        case trace_event_t::BLOCKED_IN:
+            ret.push_back({ "blocked_in",
+                            "blocked",
+                            'i',
+                            e.ts_ns,
+                            0,
+                            pid,
+                            tid,
+                            { { "block", aliases[e.id] } } });
+            break;
+        case trace_event_t::BLOCKED_OUT:
+            ret.push_back({ "blocked_out",
+                            "blocked",
+                            'i',
+                            e.ts_ns,
+                            0,
+                            pid,
+                            tid,
+                            { { "block", aliases[e.id] } } });
+            break;
+        case trace_event_t::NOTIFY_SENT:
+            ret.push_back({ "notify",
+                            "notify",
+                            'i',
+                            e.ts_ns,
+                            0,
+                            pid,
+                            tid,
+                            { { "to_tid", std::to_string(e.id) } } });
+            break;
+        case trace_event_t::NOTIFY_RECEIVED:
+            ret.push_back({ "doorbell",
+                            "notify",
+                            'i',
+                            e.ts_ns,
+                            0,
+                            pid,
+                            tid,
+                            { { "mask", std::to_string(e.id) } } });
+            break;
+        case trace_event_t::PARKED:
+            ret.push_back({ "parked", "idle", 'X', e.ts_ns, e.dur_ns, pid, tid, {} });
+            break;
+        case trace_event_t::SPINNING:
+            ret.push_back({ "spinning", "idle", 'X', e.ts_ns, e.dur_ns, pid, tid, {} });
+            break;
+        }
+    }
+    return ret;
+}
+
+void thread_wrapper::notify(scheduler_action_t action)
+{
+    switch (action) {
+    case scheduler_action_t::NOTIFY_OUTPUT:
+    case scheduler_action_t::NOTIFY_INPUT:
+    case scheduler_action_t::NOTIFY_ALL: {
+        // Recorded on the trace of the notifying thread, if it is a scheduler thread
+        GR_TRACE(NOTIFY_SENT, d_blocks[0]->id());
+
+        // Only the first ring since the last drain needs to wake the thread
+        auto prev = d_doorbell.fetch_or(1u << static_cast<uint32_t>(action));
+        if (!prev) {
+            msgq.wake();
+        }
+        break;
+    }
+    default:
+        push_message(std::make_shared<scheduler_action>(action));
+        break;
+    }
+}
+
+bool thread_wrapper::push_local_message(const message_port_callback_fcn& cb,
+                                        pmtf::pmt_sptr msg)
+{
+    if (std::this_thread::get_id() != d_thread_id.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    d_local_msgs.emplace_back(&cb, std::move(msg));
+    return true;
+}
+
+void thread_wrapper::spin()
+{
+    auto deadline = std::chrono::steady_clock::now() + d_spin_budget;
+    while (msgq.empty() && d_doorbell.load(std::memory_order_relaxed) == 0 &&
+           !d_thread_stopped.load(std::memory_order_relaxed)) {
+        // Reading the clock costs more than a pause, so only check it now and then
+        for (int i = 0; i < 64; i++) {
+            thread::cpu_relax();
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+    }
+}
+
+void thread_wrapper::handle_local_messages()
+{
+    // Only the messages waiting now: callbacks can post again, and blocks that message
+    // each other would otherwise keep this thread here forever.  What they post is
+    // handled on the next pass, after the queue, the doorbell and the stream work
+    d_local_batch.swap(d_local_msgs);
+    for (auto& [cb, msg] : d_local_batch) {
+        if (d_thread_stopped) {
+            break;
+        }
+        (*cb)(msg);
+    }
+    d_local_batch.clear();
+}
+
 bool thread_wrapper::handle_work_notification()
 {
-    auto s = _exec->run_one_iteration(d_blocks);
-
-    // Based on state of the run_one_iteration, do things
-    // If any of the blocks are done, notify the flowgraph monitor
-    for (auto elem : s) {
-        if (elem.second == executor_iteration_status::DONE) {
-            GR_LOG_DEBUG(
-                _debug_logger, "Signalling DONE to FGM from block {}", elem.first);
-            d_fgmon->push_message(
-                fg_monitor_message(fg_monitor_message_t::DONE, id(), elem.first));
-            break; // only notify the fgmon once
+    // Run the group to quiescence: keep making passes over the blocks as long as any of
+    // them made progress, so that a chain on this thread doesn't need to bounce
+    // notifications through the queue.  Bail out early if messages are waiting, so
+    // that message ports and control messages are not starved
+    bool progress = true;
+    while (progress) {
+        auto& s = _exec->run_one_iteration();
+
+        // Based on state of the run_one_iteration, do things
+        // Tell the flowgraph monitor about each block once it is done
+        for (size_t i = 0; i < s.size(); i++) {
+            if (s[i] == executor_iteration_status::DONE && !d_done_reported[i]) {
+                d_done_reported[i] = true;
+                GR_LOG_DEBUG(_debug_logger,
+                             "Signalling DONE to FGM from block {}",
+                             d_blocks[i]->id());
+                d_fgmon->push_message(fg_monitor_message(
+                    fg_monitor_message_t::DONE, id(), d_blocks[i]->id()));
+            }
+        }
+
+        progress = false;
+        for (auto st : s) {
+            if (st == executor_iteration_status::READY) {
+                progress = true;
+            }
+        }
+
+        if (d_thread_stopped || !msgq.empty()) {
+            break;
         }
     }
 
     bool notify_self_ = false;
-    for (auto elem : s) {
-        if (elem.second == executor_iteration_status::READY ||
-            elem.second == executor_iteration_status::BLKD_OUT) {
+    for (auto st : _exec->status()) {
+        if (st == executor_iteration_status::READY ||
+            st == executor_iteration_status::BLKD_OUT) {
             notify_self_ = true;
         }
     }
@@ -80,6 +254,7 @@ bool thread_wrapper::handle_work_notification()
 
 void thread_wrapper::thread_body(thread_wrapper* top)
 {
+    top->d_thread_id = std::this_thread::get_id();
     GR_LOG_INFO(top->_logger, "starting thread");
 
 #if defined(_MSC_VER) || defined(__MINGW32__)
@@ -108,6 +283,11 @@ void thread_wrapper::thread_body(thread_wrapper* top)
 
     bool blocking_queue = true;
     while (!top->d_thread_stopped) {
+#ifdef GR_ENABLE_TRACING
+        trace_ring::current() = top->d_tracing.load(std::memory_order_acquire)
+                                    ? top->d_trace.get()
+                                    : nullptr;
+#endif
 
         scheduler_message_sptr msg;
 
@@ -116,7 +296,15 @@ void thread_wrapper::thread_body(thread_wrapper* top)
         bool do_some_work = false;
         while (valid) {
             if (blocking_queue) {
-                valid = top->pop_message(msg);
+                // Spin and park separately, so that the trace tells them apart
+                if (top->d_spin_budget.count() > 0) {
+                    GR_TRACE_BEGIN(spin);
+                    top->spin();
+                    GR_TRACE_END(spin, SPINNING, 0);
+                }
+                GR_TRACE_BEGIN(park);
+                valid = top->wait_message(msg);
+                GR_TRACE_END(park, PARKED, 0);
             } else {
                 valid = top->pop_message_nonblocking(msg);
             }
@@ -132,14 +320,6 @@ void thread_wrapper::thread_body(thread_wrapper* top)
 
                     auto action = std::static_pointer_cast<scheduler_action>(msg);
                     switch (action->action()) {
-                    case scheduler_action_t::DONE:
-                        // fgmon says that we need to be done, wrap it up
-                        // each scheduler could handle this in a different way
-                        gr_log_debug(top->_debug_logger,
-                                     "fgm signaled DONE, pushing flushed");
-                        top->d_fgmon->push_message(
-                            fg_monitor_message(fg_monitor_message_t::FLUSHED, top->id()));
-                        break;
                     case scheduler_action_t::EXIT:
                         gr_log_debug(top->_debug_logger,
                                      "fgm signaled EXIT, exiting thread");
@@ -183,12 +363,23 @@ void thread_wrapper::thread_body(thread_wrapper* top)
             }
         }
 
+        top->handle_local_messages();
+
+        // Drain the coalesced notifications from neighboring blocks
+        auto doorbell = top->d_doorbell.exchange(0);
+        if (doorbell) {
+            GR_TRACE(NOTIFY_RECEIVED, doorbell);
+            gr_log_debug(top->_debug_logger, "doorbell {:#x}", doorbell);
+            do_some_work = true;
+        }
+
         bool work_returned_ready = false;
         if (do_some_work) {
             work_returned_ready = top->handle_work_notification();
         }
 
-        if (!work_returned_ready) {
+        // Messages posted during work are delivered on the next pass, without waiting
+        if (!work_returned_ready && top->d_local_msgs.empty()) {
             blocking_queue = true;
         }
     }
@@ -63,3 +63,89 @@ TEST(SchedulerBlockGrouping, BasicBlockGrouping)
         }
     }
 }
+
+TEST(SchedulerBlockGrouping, AutoPartition)
+{
+    int nsamples = 100000;
+    std::vector<gr_complex> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = gr_complex(2 * i, 2 * i + 1);
+    }
+
+    size_t nblocks = 8;
+    auto make_chain = [&](flowgraph_sptr fg) {
+        std::vector<block_sptr> chain;
+        chain.push_back(blocks::vector_source_c::make_cpu(
+            blocks::vector_source_c::block_args{ input_data, false }));
+        for (size_t i = 0; i < nblocks; i++) {
+            chain.push_back(blocks::multiply_const_cc::make({ 1.0f, 1 }));
+        }
+        chain.push_back(blocks::vector_sink_c::make_cpu());
+        for (size_t i = 1; i < chain.size(); i++) {
+            fg->connect(chain[i - 1], 0, chain[i], 0);
+        }
+        return chain;
+    };
+
+    // Warm-up run with the performance counters enabled
+    {
+        flowgraph_sptr fg(new flowgraph());
+        auto chain = make_chain(fg);
+        auto sch = schedulers::scheduler_mt::make("mtsched");
+        sch->set_perf_counters(true);
+        fg->add_scheduler(sch);
+        fg->validate();
+        fg->start();
+        fg->wait();
+
+        auto profile = fg->perf_counters();
+        EXPECT_EQ(profile.size(), chain.size());
+        for (size_t i = 1; i <= nblocks; i++) {
+            auto& c = profile[chain[i]->alias()];
+            EXPECT_GT(c.work_calls, 0u);
+            EXPECT_EQ(c.items_in, (uint64_t)nsamples);
+            EXPECT_EQ(c.items_out, (uint64_t)nsamples);
+            EXPECT_LE(c.work_ns_min, c.work_ns_max);
+            EXPECT_LE(c.work_ns_max, c.work_ns);
+            EXPECT_LE(c.input_fullness, 1.0);
+            EXPECT_LE(c.output_fullness, 1.0);
+        }
+    }
+
+    // One expensive block in the middle gets a thread of its own, its neighbors are
+    // grouped on either side of it
+    flowgraph_sptr fg(new flowgraph());
+    auto chain = make_chain(fg);
+    block_profile profile;
+    for (auto& b : chain) {
+        profile[b->alias()].work_ns = 1;
+    }
+    profile[chain[4]->alias()].work_ns = 100;
+
+    auto sch = schedulers::scheduler_mt::make("mtsched");
+    sch->set_auto_partition(profile, 3);
+    fg->add_scheduler(sch);
+    fg->validate();
+
+    auto& groups = sch->block_groups();
+    ASSERT_EQ(groups.size(), 3u);
+    EXPECT_EQ(groups[0].blocks().size(), 4u);
+    EXPECT_EQ(groups[1].blocks().size(), 1u);
+    EXPECT_EQ(groups[1].blocks()[0], chain[4]);
+    EXPECT_EQ(groups[2].blocks().size(), 5u);
+
+    auto path = testing::TempDir() + "qa_block_grouping_groups.txt";
+    schedulers::auto_partitioner::save_groups(path, groups);
+    auto loaded = schedulers::auto_partitioner::load_groups(path, chain);
+    ASSERT_EQ(loaded.size(), groups.size());
+    for (size_t i = 0; i < groups.size(); i++) {
+        EXPECT_EQ(loaded[i].name(), groups[i].name());
+        EXPECT_EQ(loaded[i].blocks(), groups[i].blocks());
+    }
+
+    fg->start();
+    fg->wait();
+
+    auto snk = std::static_pointer_cast<blocks::vector_sink_c>(chain.back());
+    EXPECT_EQ(snk->data(), input_data);
+}
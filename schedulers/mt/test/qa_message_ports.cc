@@ -36,6 +36,104 @@ TEST(SchedulerMTMessagePassing, Forward)
     }
 
     fg->start();
-    fg->wait();
 
+    // Nothing ends a flowgraph of message blocks by itself
+    auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    while (blk3->message_count() < 10 && std::chrono::steady_clock::now() < timeout) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    fg->stop();
+
+    EXPECT_EQ(blk3->message_count(), 10u);
+}
+
+/**
+ * @brief Messages per second through a chain of msg_forward blocks
+ *
+ * Runs the chain once with every block on one thread, where messages between blocks
+ * take the same-thread path, and once with a thread per block
+ */
+double run_forward_chain(size_t nblocks, size_t nmsgs, bool one_thread)
+{
+    std::vector<blocks::msg_forward::sptr> blks;
+    std::vector<block_sptr> group;
+    flowgraph_sptr fg(new flowgraph());
+    for (size_t i = 0; i < nblocks; i++) {
+        blks.push_back(blocks::msg_forward::make({}));
+        group.push_back(blks.back());
+        if (i > 0) {
+            fg->connect(blks[i - 1], "out", blks[i], "in");
+        }
+    }
+
+    std::shared_ptr<schedulers::scheduler_mt> sched(new schedulers::scheduler_mt());
+    if (one_thread) {
+        sched->add_block_group(group, "chain");
+    }
+    fg->set_scheduler(sched);
+    fg->validate();
+    fg->start();
+
+    auto msg = pmtf::pmt_string::make("message");
+    auto src_port = blks[0]->get_message_port("out");
+    auto t1 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < nmsgs; i++) {
+        src_port->post(msg);
+    }
+    auto timeout = t1 + std::chrono::seconds(60);
+    while (blks.back()->message_count() < nmsgs &&
+           std::chrono::steady_clock::now() < timeout) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    fg->stop();
+
+    EXPECT_EQ(blks.back()->message_count(), nmsgs);
+    return nmsgs / std::chrono::duration<double>(t2 - t1).count();
+}
+
+TEST(SchedulerMTMessagePassing, ForwardChainThroughput)
+{
+    size_t nblocks = 8;
+    size_t nmsgs = 100000;
+
+    auto same_thread = run_forward_chain(nblocks, nmsgs, true);
+    auto per_block = run_forward_chain(nblocks, nmsgs, false);
+
+    std::cout << nblocks << " msg_forward blocks, " << nmsgs << " messages" << std::endl;
+    std::cout << "[PROFILE_THROUGHPUT] one thread: " << same_thread
+              << " msgs/s, thread per block: " << per_block << " msgs/s" << std::endl;
+}
+
+TEST(SchedulerMTMessagePassing, Loop)
+{
+    // A request/response pair connected both ways is a cycle of message edges, which
+    // must not stop the flowgraph from running, whether or not the pair shares a thread
+    for (bool one_thread : { false, true }) {
+        auto blk1 = blocks::msg_forward::make({});
+        auto blk2 = blocks::msg_forward::make({});
+
+        flowgraph_sptr fg(new flowgraph());
+        fg->connect(blk1, "out", blk2, "in");
+        fg->connect(blk2, "out", blk1, "in");
+
+        std::shared_ptr<schedulers::scheduler_mt> sched(new schedulers::scheduler_mt());
+        if (one_thread) {
+            sched->add_block_group({ blk1, blk2 }, "pair");
+        }
+        fg->set_scheduler(sched);
+        EXPECT_NO_THROW(fg->validate());
+        fg->start();
+
+        blk1->get_message_port("out")->post(pmtf::pmt_string::make("message"));
+        auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+        while ((blk1->message_count() < 10 || blk2->message_count() < 10) &&
+               std::chrono::steady_clock::now() < timeout) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        fg->stop();
+
+        EXPECT_GE(blk1->message_count(), 10u);
+        EXPECT_GE(blk2->message_count(), 10u);
+    }
 }
@@ -1,15 +1,24 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstring>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <sstream>
 #include <thread>
 
 #include <gnuradio/blocks/copy.hh>
+#include <gnuradio/blocks/head.hh>
 #include <gnuradio/blocks/multiply_const.hh>
+#include <gnuradio/blocks/null_source.hh>
 #include <gnuradio/blocks/vector_sink.hh>
 #include <gnuradio/blocks/vector_source.hh>
 #include <gnuradio/flowgraph.hh>
 #include <gnuradio/schedulers/mt/scheduler_mt.hh>
+#include <gnuradio/spmc_buffer.hh>
 #include <gnuradio/vmcircbuf.hh>
 
 using namespace gr;
@@ -171,3 +180,210 @@ TEST(SchedulerMTTest, CustomCPUBuffers)
     EXPECT_EQ(snk1->data(), input_data);
     EXPECT_EQ(snk2->data(), input_data);
 }
+
+TEST(SchedulerMTTest, TmpfileBuffers)
+{
+    int nsamples = 100000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+    auto src = blocks::vector_source_f::make({ input_data, false });
+    auto copy1 = blocks::copy::make({ sizeof(float) });
+    auto copy2 = blocks::copy::make({ sizeof(float) });
+    auto snk = blocks::vector_sink_f::make();
+
+    flowgraph_sptr fg(new flowgraph());
+    fg->connect(src, 0, copy1, 0)->set_custom_buffer(VMCIRC_BUFFER_MMAP_TMPFILE_ARGS);
+    fg->connect(copy1, 0, copy2, 0)
+        ->set_custom_buffer(vmcirc_buffer_properties::make(
+            vmcirc_buffer_type::MMAP_TMPFILE, vmcirc_page_type::TRANSPARENT_HUGE, true));
+    fg->connect(copy2, 0, snk, 0)
+        ->set_custom_buffer(vmcirc_buffer_properties::make(
+            vmcirc_buffer_type::MMAP_TMPFILE, vmcirc_page_type::HUGETLB, true));
+
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk->data(), input_data);
+}
+
+TEST(SchedulerMTTest, SPMCBufferFanout)
+{
+    int nsamples = 1000000;
+    int nblocks = 4;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+
+    auto src = blocks::vector_source_f::make({ input_data, false });
+    std::vector<blocks::copy::sptr> copy_blks(nblocks);
+    std::vector<blocks::vector_sink_f::sptr> sink_blks(nblocks);
+    for (int i = 0; i < nblocks; i++) {
+        copy_blks[i] = blocks::copy::make({ sizeof(float) });
+        sink_blks[i] = blocks::vector_sink_f::make();
+    }
+
+    flowgraph_sptr fg(new flowgraph());
+    for (int i = 0; i < nblocks; i++) {
+        fg->connect(src, 0, copy_blks[i], 0)->set_custom_buffer(SPMC_BUFFER_ARGS);
+        fg->connect(copy_blks[i], 0, sink_blks[i], 0)
+            ->set_custom_buffer(SPMC_BUFFER_ARGS);
+    }
+
+    fg->start();
+    fg->wait();
+
+    for (int i = 0; i < nblocks; i++) {
+        EXPECT_EQ(sink_blks[i]->data(), input_data);
+    }
+}
+
+TEST(SchedulerMTTest, TraceFile)
+{
+    int nsamples = 100000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+    auto src = blocks::vector_source_f::make_cpu({ input_data, false });
+    auto mult = blocks::multiply_const_ff::make_cpu({ 1.0 });
+    auto snk = blocks::vector_sink_f::make_cpu();
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, mult, 0);
+    fg->connect(mult, 0, snk, 0);
+
+    // Events are only recorded with enable_tracing, but the file is always written
+    auto path = testing::TempDir() + "qa_scheduler_mt_trace.json";
+    fg->set_trace_file(path);
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk->data(), input_data);
+
+    std::ifstream ifs(path);
+    ASSERT_TRUE(ifs.good());
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    auto json = ss.str();
+    EXPECT_EQ(json.find("{\"displayTimeUnit\": \"ns\", \"traceEvents\": ["), 0u);
+    EXPECT_NE(json.find("\"process_name\""), std::string::npos);
+    EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+
+#ifdef GR_ENABLE_TRACING
+    // With tracing built in, every block has recorded its work calls
+    for (auto& b : std::vector<block_sptr>{ src, mult, snk }) {
+        EXPECT_NE(json.find("{\"name\": \"" + b->alias() + "\", \"cat\": \"work\""),
+                  std::string::npos)
+            << b->alias();
+    }
+#endif
+}
+
+TEST(SchedulerMTTest, ShortFlowgraphs)
+{
+    // Many back to back runs of a small flowgraph, each of which has to finish on its own
+    // once the data is through
+    int nruns = 100;
+    std::vector<float> input_data(1000);
+    for (size_t i = 0; i < input_data.size(); i++) {
+        input_data[i] = i;
+    }
+
+    for (int r = 0; r < nruns; r++) {
+        auto src = blocks::vector_source_f::make_cpu({ input_data, false });
+        auto cp = blocks::copy::make({ sizeof(float) });
+        auto snk = blocks::vector_sink_f::make_cpu();
+
+        auto fg = flowgraph::make();
+        fg->connect(src, 0, cp, 0);
+        fg->connect(cp, 0, snk, 0);
+        fg->start();
+
+        // Only guards against a hang
+        ASSERT_EQ(fg->completion().wait_for(std::chrono::seconds(30)),
+                  std::future_status::ready);
+        fg->wait();
+
+        ASSERT_EQ(snk->data(), input_data);
+    }
+}
+
+TEST(SchedulerMTTest, DoneMidChain)
+{
+    // head finishes in the middle of the chain: the sink drains what it produced and the
+    // source stops once nothing reads its output
+    size_t N = 100000;
+    auto src = blocks::null_source::make({ sizeof(float) });
+    auto hd = blocks::head::make_cpu({ sizeof(float), N });
+    auto cp = blocks::copy::make({ sizeof(float) });
+    auto snk = blocks::vector_sink_f::make_cpu();
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, hd, 0);
+    fg->connect(hd, 0, cp, 0);
+    fg->connect(cp, 0, snk, 0);
+    fg->start();
+
+    auto done = fg->completion();
+    EXPECT_EQ(done.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    fg->wait();
+
+    EXPECT_EQ(snk->data().size(), N);
+}
+
+/**
+ * @brief Counts its input, and has an optional output that may be left unconnected
+ *
+ */
+class tap_sink : public block
+{
+private:
+    std::atomic<size_t> d_count{ 0 };
+
+public:
+    typedef std::shared_ptr<tap_sink> sptr;
+    tap_sink() : block("tap_sink")
+    {
+        add_port(untyped_port::make("in", port_direction_t::INPUT, sizeof(float)));
+        add_port(
+            untyped_port::make("out", port_direction_t::OUTPUT, sizeof(float), true));
+    }
+
+    work_return_code_t work(std::vector<block_work_input>& work_input,
+                            std::vector<block_work_output>& work_output) override
+    {
+        auto n = work_input[0].n_items;
+        if (!work_output.empty()) {
+            n = std::min(n, work_output[0].n_items);
+            memcpy(work_output[0].items(), work_input[0].items(), n * sizeof(float));
+            work_output[0].produce(n);
+        }
+        work_input[0].consume(n);
+        d_count.fetch_add(n, std::memory_order_relaxed);
+        return work_return_code_t::WORK_OK;
+    }
+
+    size_t count() { return d_count.load(std::memory_order_relaxed); }
+};
+
+TEST(SchedulerMTTest, OptionalOutputUnconnected)
+{
+    // Nothing is connected to the output, which is not the same as nothing reading it
+    // anymore - the block has to run until its input is done
+    std::vector<float> input_data(100000);
+    auto src = blocks::vector_source_f::make_cpu({ input_data, false });
+    auto tap = std::make_shared<tap_sink>();
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, tap, 0);
+    fg->start();
+
+    auto done = fg->completion();
+    EXPECT_EQ(done.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    fg->wait();
+
+    EXPECT_EQ(tap->count(), input_data.size());
+}
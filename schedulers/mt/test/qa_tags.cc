@@ -256,4 +256,42 @@ TEST(SchedulerMTTags, t5)
     BOOST_REQUIRE_EQUAL(tags1.size(), (size_t)4);
     BOOST_REQUIRE_EQUAL(tags2.size(), (size_t)8);
 }
-#endif
\ No newline at end of file
+#endif
+
+TEST(SchedulerMTTags, DenseTags)
+{
+    // A tag every few items - the tag store must keep up without slowing down
+    size_t N = 400000;
+    size_t when = 10;
+    auto fg = flowgraph::make();
+    auto src = gr::blocks::null_source::make({ sizeof(int) });
+    auto head = gr::blocks::head::make_cpu({ sizeof(int), N });
+    auto ann0 = gr::blocks::annotator::make_cpu(
+        { when, sizeof(int), 1, 1, tag_propagation_policy_t::TPP_ALL_TO_ALL });
+    auto ann1 = gr::blocks::annotator::make_cpu(
+        { when, sizeof(int), 1, 1, tag_propagation_policy_t::TPP_ALL_TO_ALL });
+    auto ann2 = gr::blocks::annotator::make_cpu(
+        { when, sizeof(int), 1, 1, tag_propagation_policy_t::TPP_ALL_TO_ALL });
+    auto snk = gr::blocks::null_sink::make({ sizeof(int) });
+
+    fg->connect(src, 0, head, 0);
+    fg->connect(head, 0, ann0, 0);
+    fg->connect(ann0, 0, ann1, 0);
+    fg->connect(ann1, 0, ann2, 0);
+    fg->connect(ann2, 0, snk, 0);
+
+    auto sched = schedulers::scheduler_mt::make();
+    fg->set_scheduler(sched);
+    fg->validate();
+
+    fg->run();
+
+    std::vector<gr::tag_t> tags1 = ann1->data();
+    std::vector<gr::tag_t> tags2 = ann2->data();
+
+    EXPECT_EQ(tags1.size(), N / when);
+    EXPECT_EQ(tags2.size(), 2 * N / when);
+    for (size_t i = 1; i < tags2.size(); i++) {
+        EXPECT_LE(tags2[i - 1].offset, tags2[i].offset);
+    }
+}
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <gnuradio/blocks/copy.hh>
+#include <gnuradio/blocks/head.hh>
+#include <gnuradio/blocks/null_sink.hh>
+#include <gnuradio/blocks/null_source.hh>
+#include <gnuradio/flowgraph.hh>
+#include <gnuradio/realtime.hh>
+#include <gnuradio/schedulers/mt/scheduler_mt.hh>
+#include <gnuradio/schedulers/ws/scheduler_ws.hh>
+#include <gnuradio/vmcircbuf.hh>
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+using namespace gr;
+
+int main(int argc, char* argv[])
+{
+    uint64_t samples;
+    int nblocks;
+    int nworkers;
+    int veclen;
+    int sched_type;
+    bool rt_prio = false;
+
+    po::options_description desc("Work Stealing Scheduler Fanout");
+    desc.add_options()("help,h", "display help")
+        ("samples", po::value<uint64_t>(&samples)->default_value(15000000),"Number of samples")
+        ("veclen", po::value<int>(&veclen)->default_value(1), "Vector Length")
+        ("nblocks", po::value<int>(&nblocks)->default_value(1), "Number of copy blocks")
+        ("nworkers", po::value<int>(&nworkers)->default_value(0), "Number of worker threads (0: one per hardware thread)")
+        ("scheduler", po::value<int>(&sched_type)->default_value(1), "Scheduler (0: mt thread per block, 1: work stealing)")
+        ("rt_prio", "Enable Real-time priority");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    if (vm.count("rt_prio")) {
+        rt_prio = true;
+    }
+
+    if (rt_prio && gr::enable_realtime_scheduling() != RT_OK) {
+        std::cout << "Error: failed to enable real-time scheduling." << std::endl;
+    }
+
+    {
+        auto src = blocks::null_source::make({sizeof(gr_complex) * veclen});
+        auto head = blocks::head::make_cpu({sizeof(gr_complex) * veclen, samples / veclen});
+
+        std::vector<blocks::null_sink::sptr> sink_blks(nblocks);
+        std::vector<blocks::copy::sptr> copy_blks(nblocks);
+        for (int i = 0; i < nblocks; i++) {
+            copy_blks[i] = blocks::copy::make({sizeof(gr_complex) * veclen});
+            sink_blks[i] = blocks::null_sink::make({sizeof(gr_complex) * veclen});
+        }
+        flowgraph_sptr fg(new flowgraph());
+
+        fg->connect(src, 0, head, 0);
+        for (int i = 0; i < nblocks; i++) {
+            fg->connect(head, 0, copy_blks[i], 0);
+            fg->connect(copy_blks[i], 0, sink_blks[i], 0);
+        }
+
+        if (sched_type == 0) {
+            fg->add_scheduler(schedulers::scheduler_mt::make("mt"));
+        } else {
+            fg->add_scheduler(schedulers::scheduler_ws::make("ws", 32768, nworkers));
+        }
+        fg->validate();
+
+        auto t1 = std::chrono::steady_clock::now();
+
+        fg->start();
+        fg->wait();
+
+        auto t2 = std::chrono::steady_clock::now();
+        auto time =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / 1e9;
+
+        std::cout << "[PROFILE_TIME]" << time << "[PROFILE_TIME]" << std::endl;
+    }
+}
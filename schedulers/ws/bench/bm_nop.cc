@@ -0,0 +1,98 @@
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <gnuradio/blocks/nop.hh>
+#include <gnuradio/blocks/nop_head.hh>
+#include <gnuradio/blocks/null_sink.hh>
+#include <gnuradio/blocks/nop_source.hh>
+#include <gnuradio/flowgraph.hh>
+#include <gnuradio/realtime.hh>
+#include <gnuradio/schedulers/mt/scheduler_mt.hh>
+#include <gnuradio/schedulers/ws/scheduler_ws.hh>
+#include <gnuradio/vmcircbuf.hh>
+
+#include <boost/program_options.hpp>
+namespace po = boost::program_options;
+
+using namespace gr;
+
+int main(int argc, char* argv[])
+{
+    uint64_t samples;
+    int nblocks;
+    int nworkers;
+    int veclen;
+    int sched_type;
+    bool rt_prio = false;
+
+    po::options_description desc("Work Stealing Scheduler Nop Chain");
+    desc.add_options()("help,h", "display help")(
+        "samples",
+        po::value<uint64_t>(&samples)->default_value(15000000),
+        "Number of samples")(
+        "veclen", po::value<int>(&veclen)->default_value(1), "Vector Length")(
+        "nblocks", po::value<int>(&nblocks)->default_value(1), "Number of nop blocks")(
+        "nworkers",
+        po::value<int>(&nworkers)->default_value(0),
+        "Number of worker threads (0: one per hardware thread)")(
+        "scheduler",
+        po::value<int>(&sched_type)->default_value(1),
+        "Scheduler (0: mt thread per block, 1: work stealing)")(
+        "rt_prio", "Enable Real-time priority");
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+
+    if (vm.count("rt_prio")) {
+        rt_prio = true;
+    }
+
+    if (rt_prio && gr::enable_realtime_scheduling() != RT_OK) {
+        std::cout << "Error: failed to enable real-time scheduling." << std::endl;
+    }
+
+    {
+        auto src = blocks::nop_source::make({ sizeof(gr_complex) * veclen });
+        auto head =
+            blocks::nop_head::make({ sizeof(gr_complex) * veclen, samples / veclen });
+        auto snk = blocks::null_sink::make({ sizeof(gr_complex) * veclen });
+        std::vector<blocks::nop::sptr> blks(nblocks);
+        for (int i = 0; i < nblocks; i++) {
+            blks[i] = blocks::nop::make({ sizeof(gr_complex) * veclen });
+        }
+        flowgraph_sptr fg(new flowgraph());
+
+        fg->connect(src, 0, head, 0);
+        fg->connect(head, 0, blks[0], 0);
+        for (int i = 0; i < nblocks - 1; i++) {
+            fg->connect(blks[i], 0, blks[i + 1], 0);
+        }
+        fg->connect(blks[nblocks - 1], 0, snk, 0);
+
+        if (sched_type == 0) {
+            fg->add_scheduler(schedulers::scheduler_mt::make("mt", 32768));
+        } else {
+            fg->add_scheduler(schedulers::scheduler_ws::make("ws", 32768, nworkers));
+        }
+
+        fg->validate();
+
+        auto t1 = std::chrono::steady_clock::now();
+
+        fg->start();
+        fg->wait();
+
+        auto t2 = std::chrono::steady_clock::now();
+        auto time =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count() / 1e9;
+
+        std::cout << "[PROFILE_TIME]" << time << "[PROFILE_TIME]" << std::endl;
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <gnuradio/block.hh>
+#include <gnuradio/flowgraph_monitor.hh>
+#include <gnuradio/mpsc_queue.hh>
+#include <gnuradio/neighbor_interface.hh>
+#include <gnuradio/scheduler_message.hh>
+#include <gnuradio/schedulers/mt/graph_executor.hh>
+
+#include <atomic>
+
+namespace gr {
+namespace schedulers {
+
+class worker_pool;
+
+/**
+ * @brief Schedulable unit of the work-stealing scheduler
+ *
+ * Wraps a single block and acts as the parent interface of all its ports, so that
+ * notifications from neighboring blocks mark the task as ready and hand it to the worker
+ * pool.  A task is executed by at most one worker at a time; notifications that arrive
+ * while it is running cause it to be requeued once the current iteration finishes.
+ *
+ */
+class block_task : public neighbor_interface
+{
+private:
+    enum task_state : int { IDLE, QUEUED, RUNNING, RUNNING_NOTIFIED };
+
+    block_sptr d_block;
+    int _id;
+    worker_pool* d_pool;
+    flowgraph_monitor_sptr d_fgmon;
+    std::unique_ptr<graph_executor> _exec;
+
+    /**
+     * @brief Message port messages waiting to be delivered on the next run
+     *
+     */
+    mpsc_queue<scheduler_message_sptr> msgq;
+
+    std::atomic<int> d_state = IDLE;
+    bool d_done = false;
+
+    logger_sptr _logger;
+    logger_sptr _debug_logger;
+
+public:
+    typedef std::shared_ptr<block_task> sptr;
+
+    static sptr make(int id,
+                     block_sptr blk,
+                     buffer_manager::sptr bufman,
+                     worker_pool* pool,
+                     flowgraph_monitor_sptr fgmon)
+    {
+        return std::make_shared<block_task>(id, blk, bufman, pool, fgmon);
+    }
+
+    block_task(int id,
+               block_sptr blk,
+               buffer_manager::sptr bufman,
+               worker_pool* pool,
+               flowgraph_monitor_sptr fgmon);
+
+    int id() { return _id; }
+    block_sptr block() { return d_block; }
+
+    void push_message(scheduler_message_sptr msg) override;
+    void notify(scheduler_action_t action) override { notify(); }
+
+    /**
+     * @brief Mark the task as ready, queueing it on the pool if it is idle
+     *
+     */
+    void notify();
+
+    /**
+     * @brief Execute one iteration of the block - called only from a pool worker
+     *
+     */
+    void run();
+};
+
+} // namespace schedulers
+} // namespace gr
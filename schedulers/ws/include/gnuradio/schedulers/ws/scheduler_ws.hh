@@ -0,0 +1,80 @@
+#pragma once
+
+#include <gnuradio/domain.hh>
+#include <gnuradio/graph_utils.hh>
+#include <gnuradio/scheduler.hh>
+#include <gnuradio/vmcircbuf.hh>
+
+#include "block_task.hh"
+#include "worker_pool.hh"
+
+namespace gr {
+namespace schedulers {
+
+/**
+ * @brief Work-stealing thread-pool scheduler
+ *
+ * Rather than dedicating an OS thread to every block (or block group), each block is
+ * wrapped in a block_task and executed on a fixed pool of workers whenever one of its
+ * neighbors signals that it may be able to make progress.
+ *
+ */
+class scheduler_ws : public scheduler
+{
+private:
+    const int s_fixed_buf_size;
+    std::unique_ptr<worker_pool> d_pool;
+    std::vector<block_task::sptr> d_tasks;
+    std::map<nodeid_t, block_task::sptr> _block_task_map;
+    flowgraph_monitor_sptr d_fgmon;
+
+public:
+    typedef std::shared_ptr<scheduler_ws> sptr;
+    static sptr make(const std::string name = "work_stealing",
+                     const unsigned int fixed_buf_size = 32768,
+                     const unsigned int nworkers = 0,
+                     const std::vector<unsigned int>& affinity_mask = {})
+    {
+        return std::make_shared<scheduler_ws>(
+            name, fixed_buf_size, nworkers, affinity_mask);
+    }
+
+    /**
+     * @brief Construct a new work-stealing scheduler
+     *
+     * @param name
+     * @param fixed_buf_size default buffer size in bytes
+     * @param nworkers number of worker threads (0: one per hardware thread)
+     * @param affinity_mask optional list of cores the worker threads are bound to
+     */
+    scheduler_ws(const std::string name = "work_stealing",
+                 const unsigned int fixed_buf_size = 32768,
+                 const unsigned int nworkers = 0,
+                 const std::vector<unsigned int>& affinity_mask = {})
+        : scheduler(name), s_fixed_buf_size(fixed_buf_size)
+    {
+        _default_buf_properties =
+            vmcirc_buffer_properties::make(vmcirc_buffer_type::AUTO);
+        d_pool = std::make_unique<worker_pool>(name, nworkers, affinity_mask);
+    }
+    ~scheduler_ws(){};
+
+    void push_message(scheduler_message_sptr msg);
+
+    /**
+     * @brief Initialize the work-stealing scheduler
+     *
+     * Creates a block_task for each block in the subgraph and makes it the parent
+     * interface of the block's ports
+     *
+     * @param fg subgraph assigned to this scheduler
+     * @param fgmon sptr to flowgraph monitor object
+     */
+    void initialize(flat_graph_sptr fg, flowgraph_monitor_sptr fgmon);
+    void start();
+    void stop();
+    void wait();
+    void run();
+};
+} // namespace schedulers
+} // namespace gr
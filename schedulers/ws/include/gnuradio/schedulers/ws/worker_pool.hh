@@ -0,0 +1,96 @@
+#pragma once
+
+#include <gnuradio/logging.hh>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gr {
+namespace schedulers {
+
+class block_task;
+
+/**
+ * @brief Fixed pool of worker threads with per-worker deques and work stealing
+ *
+ * Each worker owns a deque of ready block tasks.  A worker pops from the back of its own
+ * deque (LIFO, so the downstream block it just notified runs next while its data is
+ * still in cache) and, when empty, steals from the front of the other workers' deques.
+ * Tasks scheduled from outside the pool are distributed round-robin.  Idle workers park
+ * on a condition variable until new tasks are scheduled.
+ *
+ */
+class worker_pool
+{
+private:
+    struct worker_queue {
+        std::mutex mutex;
+        std::deque<block_task*> tasks;
+    };
+
+    std::vector<std::unique_ptr<worker_queue>> d_queues;
+    std::vector<std::thread> d_threads;
+    std::vector<unsigned int> d_affinity_mask;
+
+    std::atomic<bool> d_stopped = false;
+    std::atomic<size_t> d_pending = 0;
+    std::atomic<size_t> d_num_sleeping = 0;
+    std::atomic<size_t> d_next_queue = 0;
+
+    std::mutex d_park_mutex;
+    std::condition_variable d_park_cond;
+
+    std::string _name;
+    logger_sptr _logger;
+    logger_sptr _debug_logger;
+
+    bool pop_local(size_t idx, block_task*& task);
+    bool steal(size_t idx, block_task*& task);
+    void park();
+    static void worker_body(worker_pool* top, size_t idx);
+
+public:
+    /**
+     * @brief Construct a new worker pool object
+     *
+     * @param name Name used for the worker threads and loggers
+     * @param nworkers Number of worker threads (0: one per hardware thread)
+     * @param affinity_mask Optional list of cores the workers are bound to
+     */
+    worker_pool(const std::string& name,
+                size_t nworkers = 0,
+                const std::vector<unsigned int>& affinity_mask = {});
+    ~worker_pool();
+
+    size_t size() { return d_queues.size(); }
+
+    /**
+     * @brief Queue a task for execution
+     *
+     * Called from a worker thread, the task is pushed to that worker's own deque.
+     * Otherwise, it is pushed round-robin to one of the workers
+     *
+     * @param task
+     */
+    void schedule(block_task* task);
+
+    void start();
+    /**
+     * @brief Signal the workers to exit - does not join them
+     *
+     */
+    void stop();
+    /**
+     * @brief Join the worker threads
+     *
+     */
+    void wait();
+};
+
+} // namespace schedulers
+} // namespace gr
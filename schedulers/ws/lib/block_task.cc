@@ -0,0 +1,90 @@
+#include "block_task.hh"
+#include "worker_pool.hh"
+
+namespace gr {
+namespace schedulers {
+
+block_task::block_task(int id,
+                       block_sptr blk,
+                       buffer_manager::sptr bufman,
+                       worker_pool* pool,
+                       flowgraph_monitor_sptr fgmon)
+    : d_block(blk), _id(id), d_pool(pool), d_fgmon(fgmon)
+{
+    _logger = logging::get_logger(blk->alias() + "_task", "default");
+    _debug_logger = logging::get_logger(blk->alias() + "_task_dbg", "debug");
+
+    _exec = std::make_unique<graph_executor>(blk->alias());
+    _exec->initialize(bufman, { blk });
+}
+
+void block_task::push_message(scheduler_message_sptr msg)
+{
+    // Stream notifications carry no payload - all they mean is "look again", so they
+    // coalesce into the task state.  Message port messages need to be delivered in
+    // order, so those are queued until the task runs
+    if (msg->type() == scheduler_message_t::MSGPORT_MESSAGE) {
+        msgq.push(msg);
+    }
+    notify();
+}
+
+void block_task::notify()
+{
+    auto state = d_state.load();
+    while (true) {
+        switch (state) {
+        case IDLE:
+            if (d_state.compare_exchange_weak(state, QUEUED)) {
+                d_pool->schedule(this);
+                return;
+            }
+            break;
+        case RUNNING:
+            if (d_state.compare_exchange_weak(state, RUNNING_NOTIFIED)) {
+                return;
+            }
+            break;
+        default: // already queued or already flagged for another pass
+            return;
+        }
+    }
+}
+
+void block_task::run()
+{
+    d_state.store(RUNNING);
+
+    scheduler_message_sptr msg;
+    while (msgq.try_pop(msg)) {
+        auto m = std::static_pointer_cast<msgport_message>(msg);
+        m->callback()(m->message());
+    }
+
+    // The executor holds only this block, so its status is in slot 0
+    auto status = _exec->run_one_iteration()[0];
+
+    bool ready = false;
+    if (status == executor_iteration_status::DONE) {
+        if (!d_done) {
+            d_done = true;
+            GR_LOG_DEBUG(
+                _debug_logger, "Signalling DONE to FGM from block {}", d_block->id());
+            d_fgmon->push_message(
+                fg_monitor_message(fg_monitor_message_t::DONE, id(), d_block->id()));
+        }
+    } else if (status == executor_iteration_status::READY) {
+        ready = true;
+    }
+
+    // A block that made progress goes straight back on the queue.  A blocked one waits
+    // for a neighbor to notify it, unless that already happened during this iteration
+    int state = RUNNING;
+    if (ready || !d_state.compare_exchange_strong(state, IDLE)) {
+        d_state.store(QUEUED);
+        d_pool->schedule(this);
+    }
+}
+
+} // namespace schedulers
+} // namespace gr
@@ -0,0 +1,98 @@
+#include <gnuradio/schedulers/ws/scheduler_ws.hh>
+
+namespace gr {
+namespace schedulers {
+
+void scheduler_ws::push_message(scheduler_message_sptr msg)
+{
+    // Use 0 for blkid all tasks
+    if (msg->blkid() == 0) {
+        if (msg->type() == scheduler_message_t::SCHEDULER_ACTION) {
+            auto action = std::static_pointer_cast<scheduler_action>(msg);
+            switch (action->action()) {
+            case scheduler_action_t::EXIT:
+                GR_LOG_DEBUG(_debug_logger, "fgm signaled EXIT, stopping workers");
+                d_pool->stop();
+                return;
+            default:
+                break;
+            }
+        }
+        for (auto& t : d_tasks) {
+            t->push_message(msg);
+        }
+    } else {
+        _block_task_map[msg->blkid()]->push_message(msg);
+    }
+}
+
+void scheduler_ws::initialize(flat_graph_sptr fg, flowgraph_monitor_sptr fgmon)
+{
+    d_fgmon = fgmon;
+    for (auto& b : fg->calc_used_blocks()) {
+        b->set_scheduler(base());
+    }
+
+    auto bufman = std::make_shared<buffer_manager>(s_fixed_buf_size);
+    bufman->initialize_buffers(fg, _default_buf_properties);
+
+    for (auto& b : fg->calc_used_blocks()) {
+        auto t = block_task::make(id(), b, bufman, d_pool.get(), fgmon);
+        d_tasks.push_back(t);
+
+        for (auto& p : b->all_ports()) {
+            p->set_parent_intf(t); // give a shared pointer to the task
+        }
+
+        _block_task_map[b->id()] = t;
+    }
+
+    GR_LOG_INFO(_logger,
+                "Scheduling {} blocks on {} workers",
+                d_tasks.size(),
+                d_pool->size());
+}
+
+void scheduler_ws::start()
+{
+    for (auto& t : d_tasks) {
+        t->block()->start();
+    }
+    d_pool->start();
+    for (auto& t : d_tasks) {
+        t->notify();
+    }
+}
+void scheduler_ws::stop()
+{
+    d_pool->stop();
+    d_pool->wait();
+    for (auto& t : d_tasks) {
+        t->block()->stop();
+    }
+}
+void scheduler_ws::wait()
+{
+    d_pool->wait();
+    for (auto& t : d_tasks) {
+        t->block()->done();
+    }
+}
+void scheduler_ws::run()
+{
+    start();
+    wait();
+}
+
+} // namespace schedulers
+} // namespace gr
+
+
+// External plugin interface for instantiating out of tree schedulers
+// TODO: name, version, other info methods
+extern "C" {
+std::shared_ptr<gr::scheduler> factory(const std::string& name = "ws", size_t buf_size = 32768)
+{
+    return gr::schedulers::scheduler_ws::make(name, buf_size);
+}
+}
@@ -0,0 +1,151 @@
+#include "worker_pool.hh"
+#include "block_task.hh"
+
+#include <gnuradio/thread.hh>
+#include <boost/format.hpp>
+
+namespace gr {
+namespace schedulers {
+
+namespace {
+// Identifies the pool and deque of the calling thread, if it is a worker
+thread_local worker_pool* t_pool = nullptr;
+thread_local size_t t_queue_idx = 0;
+} // namespace
+
+worker_pool::worker_pool(const std::string& name,
+                         size_t nworkers,
+                         const std::vector<unsigned int>& affinity_mask)
+    : d_affinity_mask(affinity_mask), _name(name)
+{
+    _logger = logging::get_logger(name + "_pool", "default");
+    _debug_logger = logging::get_logger(name + "_pool_dbg", "debug");
+
+    if (nworkers == 0) {
+        nworkers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < nworkers; i++) {
+        d_queues.push_back(std::make_unique<worker_queue>());
+    }
+}
+
+worker_pool::~worker_pool()
+{
+    stop();
+    wait();
+}
+
+void worker_pool::start()
+{
+    d_stopped = false;
+    for (size_t i = 0; i < d_queues.size(); i++) {
+        d_threads.emplace_back(worker_body, this, i);
+    }
+}
+
+void worker_pool::stop()
+{
+    {
+        std::scoped_lock guard(d_park_mutex);
+        d_stopped = true;
+    }
+    d_park_cond.notify_all();
+}
+
+void worker_pool::wait()
+{
+    for (auto& t : d_threads) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+    d_threads.clear();
+}
+
+void worker_pool::schedule(block_task* task)
+{
+    size_t idx;
+    if (t_pool == this) {
+        idx = t_queue_idx;
+    } else {
+        idx = d_next_queue++ % d_queues.size();
+    }
+
+    // Pairs with the increment of d_num_sleeping in park(), so that either the parking
+    // worker sees the new task or we see the parked worker and wake it up
+    d_pending++;
+    {
+        std::scoped_lock guard(d_queues[idx]->mutex);
+        d_queues[idx]->tasks.push_back(task);
+    }
+
+    if (d_num_sleeping.load() > 0) {
+        std::scoped_lock guard(d_park_mutex);
+        d_park_cond.notify_one();
+    }
+}
+
+bool worker_pool::pop_local(size_t idx, block_task*& task)
+{
+    auto& q = *d_queues[idx];
+    std::scoped_lock guard(q.mutex);
+    if (q.tasks.empty()) {
+        return false;
+    }
+    task = q.tasks.back();
+    q.tasks.pop_back();
+    d_pending--;
+    return true;
+}
+
+bool worker_pool::steal(size_t idx, block_task*& task)
+{
+    auto n = d_queues.size();
+    for (size_t i = 1; i < n; i++) {
+        auto& q = *d_queues[(idx + i) % n];
+        std::unique_lock<std::mutex> l(q.mutex, std::try_to_lock);
+        if (!l.owns_lock() || q.tasks.empty()) {
+            continue;
+        }
+        task = q.tasks.front();
+        q.tasks.pop_front();
+        d_pending--;
+        return true;
+    }
+    return false;
+}
+
+void worker_pool::park()
+{
+    std::unique_lock<std::mutex> l(d_park_mutex);
+    d_num_sleeping++;
+    d_park_cond.wait(l, [this] { return d_stopped || d_pending.load() > 0; });
+    d_num_sleeping--;
+}
+
+void worker_pool::worker_body(worker_pool* top, size_t idx)
+{
+    t_pool = top;
+    t_queue_idx = idx;
+
+    thread::set_thread_name(pthread_self(), str(boost::format("%s_w%d") % top->_name % idx));
+
+    if (!top->d_affinity_mask.empty()) {
+        gr::thread::thread_bind_to_processor(thread::get_current_thread_id(),
+                                             top->d_affinity_mask);
+    }
+
+    GR_LOG_DEBUG(top->_debug_logger, "starting worker {}", idx);
+
+    while (!top->d_stopped) {
+        block_task* task = nullptr;
+        if (top->pop_local(idx, task) || top->steal(idx, task)) {
+            task->run();
+        } else if (top->d_pending.load() == 0) {
+            top->park();
+        }
+    }
+}
+
+} // namespace schedulers
+} // namespace gr
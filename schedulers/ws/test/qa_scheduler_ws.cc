@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <gnuradio/blocks/copy.hh>
+#include <gnuradio/blocks/multiply_const.hh>
+#include <gnuradio/blocks/vector_sink.hh>
+#include <gnuradio/blocks/vector_source.hh>
+#include <gnuradio/flowgraph.hh>
+#include <gnuradio/schedulers/ws/scheduler_ws.hh>
+
+using namespace gr;
+
+TEST(SchedulerWSTest, TwoSinks)
+{
+    int nsamples = 100000;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+    auto src = blocks::vector_source_f::make_cpu({ input_data, false });
+    auto snk1 = blocks::vector_sink_f::make_cpu();
+    auto snk2 = blocks::vector_sink_f::make_cpu();
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, snk1, 0);
+    fg->connect(src, 0, snk2, 0);
+
+    auto sched = schedulers::scheduler_ws::make("ws", 32768, 2);
+    fg->set_scheduler(sched);
+
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk1->data(), input_data);
+    EXPECT_EQ(snk2->data(), input_data);
+}
+
+TEST(SchedulerWSTest, LongChainFewWorkers)
+{
+    // Many more blocks than workers - would be one thread per block with scheduler_mt
+    int nsamples = 100000;
+    int nblocks = 50;
+    std::vector<float> input_data(nsamples);
+    for (int i = 0; i < nsamples; i++) {
+        input_data[i] = i;
+    }
+
+    auto src = blocks::vector_source_f::make_cpu({ input_data, false });
+    auto snk = blocks::vector_sink_f::make_cpu();
+    std::vector<blocks::copy::sptr> copy_blks(nblocks);
+    for (int i = 0; i < nblocks; i++) {
+        copy_blks[i] = blocks::copy::make({ sizeof(float) });
+    }
+
+    auto fg = flowgraph::make();
+    fg->connect(src, 0, copy_blks[0], 0);
+    for (int i = 0; i < nblocks - 1; i++) {
+        fg->connect(copy_blks[i], 0, copy_blks[i + 1], 0);
+    }
+    fg->connect(copy_blks[nblocks - 1], 0, snk, 0);
+
+    auto sched = schedulers::scheduler_ws::make("ws", 32768, 3);
+    fg->set_scheduler(sched);
+
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk->data(), input_data);
+}
+
+TEST(SchedulerWSTest, MultiplyChain)
+{
+    std::vector<float> input_data{ 1.0, 2.0, 3.0, 4.0, 5.0 };
+
+    std::vector<float> expected_data;
+    for (auto d : input_data) {
+        expected_data.push_back(100.0 * 200.0 * d);
+    }
+
+    auto src = blocks::vector_source_f::make_cpu({ input_data, false });
+    auto mult1 = blocks::multiply_const_ff::make_cpu({ 100.0 });
+    auto mult2 = blocks::multiply_const_ff::make_cpu({ 200.0 });
+    auto snk = blocks::vector_sink_f::make_cpu();
+
+    flowgraph_sptr fg(new flowgraph());
+    fg->connect(src, mult1);
+    fg->connect(mult1, mult2);
+    fg->connect(mult2, snk);
+
+    auto sched = schedulers::scheduler_ws::make("ws", 32768, 1);
+    fg->set_scheduler(sched);
+
+    fg->start();
+    fg->wait();
+
+    EXPECT_EQ(snk->data(), expected_data);
+}